@@ -0,0 +1,454 @@
+#include "daemon.h"
+#include "albc/albc.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#   include <cerrno>
+#   include <csignal>
+#   include <cstring>
+#   include <sys/socket.h>
+#   include <sys/un.h>
+#   include <unistd.h>
+#endif
+
+namespace
+{
+class WorkerPool
+{
+  public:
+    explicit WorkerPool(int n)
+    {
+        for (int i = 0; i < n; ++i)
+            threads_.emplace_back([this]() { loop(); });
+    }
+
+    // 析构前会执行完所有已提交的任务
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto &t : threads_)
+            t.join();
+    }
+
+    void submit(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        cv_.notify_one();
+    }
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+
+    void loop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+                if (jobs_.empty())
+                    return;
+
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+};
+
+// 并发完成的响应按请求的序号依次写出。
+// 写出由每个输入流独占的写线程完成，求解线程只负责入队，不会因客户端读取缓慢而阻塞
+class OrderedWriter
+{
+  public:
+    explicit OrderedWriter(std::function<bool(const std::string &)> write)
+        : write_(std::move(write)), thread_([this]() { loop(); })
+    {
+    }
+
+    ~OrderedWriter()
+    {
+        if (thread_.joinable())
+            finish(next_seq_);
+    }
+
+    OrderedWriter(const OrderedWriter &) = delete;
+    OrderedWriter &operator=(const OrderedWriter &) = delete;
+
+    void complete(std::uint64_t seq, std::string response)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.emplace(seq, std::move(response));
+        bool has_ready = false;
+        for (auto it = pending_.begin(); it != pending_.end() && it->first == next_seq_; it = pending_.erase(it))
+        {
+            ready_.push_back(std::move(it->second));
+            ++next_seq_;
+            has_ready = true;
+        }
+        if (has_ready)
+            cv_.notify_one();
+    }
+
+    // 等待前total个响应全部写出（或写入失败后丢弃）后结束写线程。由读取输入的线程调用
+    void finish(std::uint64_t total)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            total_ = total;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+  private:
+    std::function<bool(const std::string &)> write_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::map<std::uint64_t, std::string> pending_;
+    std::deque<std::string> ready_;
+    std::uint64_t next_seq_ = 0;
+    std::uint64_t total_ = UINT64_MAX;
+    bool ok_ = true; // 只由写线程访问
+    std::thread thread_;
+
+    void loop()
+    {
+        while (true)
+        {
+            std::deque<std::string> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return !ready_.empty() || next_seq_ >= total_; });
+                if (ready_.empty())
+                    return;
+
+                batch.swap(ready_);
+            }
+
+            // 写入失败（对端已关闭）后丢弃剩余的响应
+            for (const auto &response : batch)
+            {
+                if (ok_)
+                    ok_ = write_(response);
+            }
+        }
+    }
+};
+
+bool append_compact(const char *data, size_t size, void *user_data)
+{
+    // 输出Json的字符串中的控制字符均已转义，原样出现的换行、制表符只是排版用的空白，去掉后整个响应占一行
+    auto &out = *static_cast<std::string *>(user_data);
+    for (size_t i = 0; i < size; ++i)
+    {
+        if (data[i] != '\n' && data[i] != '\r' && data[i] != '\t')
+            out.push_back(data[i]);
+    }
+    return true;
+}
+
+std::string escape_json(const char *str)
+{
+    std::string out;
+    for (; *str; ++str)
+    {
+        const char c = *str;
+        if (c == '"' || c == '\\')
+        {
+            out.push_back('\\');
+            out.push_back(c);
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out.append(buf);
+        }
+        else
+        {
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+std::string error_response(const char *what)
+{
+    return std::string(R"({"error":")").append(escape_json(what)).append("\"}\n");
+}
+
+std::string solve_line(const std::string &line)
+{
+    std::string response;
+    AlbcException *e = nullptr;
+    albc::RunWithJsonParamsTo(line.data(), line.size(), append_compact, &response, &e);
+    if (e)
+    {
+        response = error_response(e->what);
+        albc::FreeException(e);
+        return response;
+    }
+    response.push_back('\n');
+    return response;
+}
+
+// 将一个输入流中的请求依次编号并提交到线程池
+class RequestStream
+{
+  public:
+    RequestStream(std::shared_ptr<WorkerPool> pool, std::shared_ptr<OrderedWriter> writer)
+        : pool_(std::move(pool)), writer_(std::move(writer))
+    {
+    }
+
+    void submit(std::string line)
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.find_first_not_of(" \t") == std::string::npos)
+            return;
+
+        pool_->submit([writer = writer_, seq = next_seq_++, line = std::move(line)]() {
+            writer->complete(seq, solve_line(line));
+        });
+    }
+
+    // 不经过线程池，直接按顺序输出一个错误响应
+    void submit_error(const char *what)
+    {
+        writer_->complete(next_seq_++, error_response(what));
+    }
+
+    // 等待已提交请求的响应全部写出
+    void finish()
+    {
+        writer_->finish(next_seq_);
+    }
+
+  private:
+    std::shared_ptr<WorkerPool> pool_;
+    std::shared_ptr<OrderedWriter> writer_;
+    std::uint64_t next_seq_ = 0;
+};
+
+// 单个请求行的长度上限，超出的行以错误响应代替并丢弃至下一个换行，避免输入不含换行时缓冲区无限增长
+constexpr size_t kMaxLineSize = 64 * 1024 * 1024;
+
+// 按行提交请求直到输入结束。read_chunk读取至多size字节，返回0表示输入结束
+void read_requests(RequestStream &stream, const std::function<size_t(char *, size_t)> &read_chunk)
+{
+    std::string buf;
+    bool discarding = false; // 正在丢弃超长行的剩余部分
+    std::vector<char> chunk(64 * 1024);
+    while (true)
+    {
+        const auto n = read_chunk(chunk.data(), chunk.size());
+        if (n == 0)
+            break;
+
+        const char *begin = chunk.data();
+        const char *const end = begin + n;
+        while (begin != end)
+        {
+            const char *const newline = std::find(begin, end, '\n');
+            if (!discarding)
+                buf.append(begin, std::min(static_cast<size_t>(newline - begin), kMaxLineSize + 1 - buf.size()));
+
+            if (!discarding && buf.size() > kMaxLineSize)
+            {
+                stream.submit_error("Request line too long");
+                buf.clear();
+                discarding = true;
+            }
+
+            if (newline == end)
+                break;
+
+            if (!discarding)
+                stream.submit(std::move(buf));
+            buf.clear();
+            discarding = false;
+            begin = newline + 1;
+        }
+    }
+    if (!discarding)
+        stream.submit(std::move(buf));
+}
+
+int serve_stdin(const std::shared_ptr<WorkerPool> &pool)
+{
+    auto writer = std::make_shared<OrderedWriter>([](const std::string &response) {
+        std::cout.write(response.data(), static_cast<std::streamsize>(response.size()));
+        std::cout.flush();
+        return static_cast<bool>(std::cout);
+    });
+
+    RequestStream stream(pool, writer);
+    // istream::getline读到换行即返回，交互输入时每行请求都能立即提交；换行本身不保存，在此补回
+    read_requests(stream, [](char *buf, size_t size) -> size_t {
+        std::cin.getline(buf, static_cast<std::streamsize>(size));
+        const auto count = static_cast<size_t>(std::cin.gcount());
+        if (std::cin.bad() || count == 0)
+            return 0;
+
+        if (!std::cin.fail() && !std::cin.eof())
+        {
+            buf[count - 1] = '\n'; // 读到了换行，count包含该换行
+            return count;
+        }
+        if (!std::cin.eof())
+            std::cin.clear(); // 缓冲区已满但该行未结束
+        return count;
+    });
+
+    stream.finish();
+    return 0;
+}
+
+#ifndef _WIN32
+struct Connection
+{
+    int fd;
+
+    explicit Connection(int fd_val) : fd(fd_val)
+    {
+    }
+
+    ~Connection()
+    {
+        ::close(fd);
+    }
+};
+
+bool write_all(int fd, const std::string &data)
+{
+    size_t written = 0;
+    while (written < data.size())
+    {
+        const auto n = ::write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        written += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// 读取连接中的全部请求，等待所有响应写出后关闭连接
+void serve_connection(const std::shared_ptr<WorkerPool> &pool, int fd)
+{
+    const Connection conn(fd);
+    auto writer =
+        std::make_shared<OrderedWriter>([fd](const std::string &response) { return write_all(fd, response); });
+
+    RequestStream stream(pool, writer);
+    read_requests(stream, [fd](char *buf, size_t size) -> size_t {
+        while (true)
+        {
+            const auto n = ::read(fd, buf, size);
+            if (n < 0 && errno == EINTR)
+                continue;
+            return n > 0 ? static_cast<size_t>(n) : 0;
+        }
+    });
+    stream.finish();
+}
+
+int serve_socket(const std::shared_ptr<WorkerPool> &pool, const std::string &path)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path))
+    {
+        std::cerr << "Socket path too long: " << path << std::endl;
+        return -1;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    const int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        std::cerr << "Could not create socket: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    ::unlink(path.c_str());
+    if (::bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || ::listen(listen_fd, SOMAXCONN) < 0)
+    {
+        std::cerr << "Could not listen on socket: " << path << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd);
+        return -1;
+    }
+
+    std::cerr << "Listening on: " << path << std::endl;
+    while (true)
+    {
+        const int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+
+            std::cerr << "Could not accept connection: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        std::thread([pool, fd]() { serve_connection(pool, fd); }).detach();
+    }
+
+    ::close(listen_fd);
+    ::unlink(path.c_str());
+    return -1;
+}
+#endif
+} // namespace
+
+int run_daemon(const DaemonOptions &options)
+{
+    const int hardware_threads = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+    auto pool = std::make_shared<WorkerPool>(options.workers > 0 ? options.workers : hardware_threads);
+
+#ifndef _WIN32
+    // 客户端（或标准输出的读取方）提前断开时写入失败即可，不应终止进程
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    // 预热：首个请求会构造游戏数据快照，提前完成以免计入第一个请求的耗时
+    solve_line("{}");
+
+    if (options.socket_path.empty())
+        return serve_stdin(pool);
+
+#ifndef _WIN32
+    return serve_socket(pool, options.socket_path);
+#else
+    std::cerr << "Unix domain socket is not supported on this platform" << std::endl;
+    return -1;
+#endif
+}
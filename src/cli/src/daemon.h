@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+struct DaemonOptions
+{
+    int workers = 0;         // 求解线程数，不大于0时使用硬件线程数
+    std::string socket_path; // Unix域套接字路径，为空时从标准输入读取请求并向标准输出写入响应
+};
+
+// 常驻求解模式，调用前游戏数据须已加载。
+// 每行一个RunWithJsonParams格式的请求，在线程池上并发求解；每个连接（或标准输入）的响应按请求顺序逐行写出（NDJSON）。
+// 出错的请求以{"error":"..."}作为响应；套接字连接中超过64MiB的请求行同样以错误响应代替。
+int run_daemon(const DaemonOptions &options);
@@ -1,5 +1,7 @@
 #include "albc/albc.h"
+#include "daemon.h"
 
+#include <cstring>
 #include <fstream>
 
 #define PROGRAMOPTIONS_NO_COLORS
@@ -25,6 +27,34 @@ void read_file_to_ss(const std::string &filename, std::stringstream &ss)
     std::cout << "Read file: " << filename << ", size: " << ss.str().size() << std::endl;
 }
 
+// 守护模式下标准输出用于写出响应，日志改为写到标准错误
+bool log_to_stderr(unsigned long, const char *message, void *)
+{
+    std::cerr << message;
+    if (*message && message[std::strlen(message) - 1] != '\n')
+        std::cerr << '\n';
+    return true;
+}
+
+bool flush_log_to_stderr(unsigned long, void *)
+{
+    std::cerr.flush();
+    return true;
+}
+
+void load_game_data(AlbcGameDataDbType type, const std::string &path)
+{
+    AlbcException *e = nullptr;
+    albc::LoadGameDataFile(type, path.c_str(), &e);
+    if (e)
+    {
+        const std::string msg = std::string("Could not load game data: ").append(path).append(": ").append(e->what);
+        albc::FreeException(e);
+        throw std::runtime_error(msg);
+    }
+    std::cerr << "Loaded game data: " << path << std::endl;
+}
+
 int main(const int argc, char *argv[])
 {
 #ifdef _WIN32
@@ -32,13 +62,15 @@ int main(const int argc, char *argv[])
 #endif
 
     po::parser parser;
-    std::string game_data, player_data, character_table;
+    std::string game_data, player_data, character_table, char_meta_table;
     std::stringstream player_data_json, game_data_json, character_table_json;
     std::string log_level_str;
     std::string model_time_limit_str = "57600";
     std::string solve_time_limit_str = "60";
     std::string albc_test_mode_str;
     std::string albc_test_param_str = "0";
+    std::string socket_path;
+    std::string workers_str = "0";
 
     // add options to parser
     // add playerdata and gamedata to parser
@@ -61,6 +93,25 @@ int main(const int argc, char *argv[])
                      "PATH                            : string")
         .bind(character_table);
 
+    parser["char-meta-table"]
+        .abbreviation('M')
+        .description("Path to character meta table file. Required in daemon mode.\n"
+                     "PATH                            : string")
+        .bind(char_meta_table);
+
+    parser["socket"]
+        .abbreviation('s')
+        .description("Daemon mode: listen on this Unix domain socket instead of stdin/stdout.\n"
+                     "PATH                            : string")
+        .bind(socket_path);
+
+    parser["workers"]
+        .abbreviation('w')
+        .description("Daemon mode: number of solver threads.\n"
+                     "Default is 0 (hardware concurrency). \n"
+                     "NUM                             : int")
+        .bind(workers_str);
+
     parser["log-level"]
         .abbreviation('l')
         .description("Log level.\nDefault is WARN.\n"
@@ -85,13 +136,13 @@ int main(const int argc, char *argv[])
     parser["test-mode"]
         .abbreviation('m')
         .description("Test mode. Leave empty for normal mode.\n"
-                     "<ONCE|SEQUENTIAL|PARALLEL>      : string")
+                     "<ONCE|SEQUENTIAL|PARALLEL|RELOAD>: string")
         .bind(albc_test_mode_str);
 
     parser["test-param"]
         .abbreviation('P')
         .description("Test param.\n"
-                     "NUM_CONCURRENCY|NUM_ITERATIONS  : int")
+                     "NUM_CONCURRENCY|NUM_ITERATIONS|NUM_READERS: int")
         .bind(albc_test_param_str);
 
     auto &gen_lp = parser["lp-file"].abbreviation('L').description(
@@ -103,6 +154,9 @@ int main(const int argc, char *argv[])
     auto &all_ops = parser["all-ops"].abbreviation('a').description(
         "Show all operators info.                                  : FLAG");
 
+    auto &daemon = parser["daemon"].abbreviation('d').description(
+        "Daemon mode: serve NDJSON requests (json params format).  : FLAG");
+
     // add help to parser
     auto &help = parser["help"].abbreviation('h').description(
         "Produce help message.                                     : FLAG");
@@ -120,6 +174,38 @@ int main(const int argc, char *argv[])
         return 0;
     }
 
+    if (daemon.was_set())
+    {
+        if (game_data.empty() || character_table.empty() || char_meta_table.empty())
+        {
+            std::cerr << "Error: Missing required options! : gamedata, character-table and char-meta-table are "
+                         "required in daemon mode" << std::endl;
+            return -1;
+        }
+
+        try
+        {
+            albc::SetLogHandler(log_to_stderr, nullptr);
+            albc::SetFlushLogHandler(flush_log_to_stderr, nullptr);
+            albc::SetLogLevel(albc::ParseLogLevel(log_level_str.c_str(), ALBC_LOG_LEVEL_WARN));
+            load_game_data(ALBC_GAME_DATA_DB_BUILDING_DATA, game_data);
+            load_game_data(ALBC_GAME_DATA_DB_CHARACTER_TABLE, character_table);
+            load_game_data(ALBC_GAME_DATA_DB_CHAR_META_TABLE, char_meta_table);
+
+            DaemonOptions options;
+            options.workers = std::stoi(workers_str);
+            options.socket_path = socket_path;
+            const int ret = run_daemon(options);
+            albc::FlushLog();
+            return ret;
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Exception: " << e.what() << std::endl;
+            return -1;
+        }
+    }
+
     bool test_enabled = !albc_test_mode_str.empty();
     AlbcTestMode test_mode = albc::ParseTestMode(albc_test_mode_str.c_str(), ALBC_TEST_MODE_ONCE);
     // check if all required options are set
@@ -8,6 +8,35 @@ namespace albc
 {
 ALBC_API String RunWithJsonParams(const char* json, ALBC_E_PTR);
 
+// 与RunWithJsonParams相同，但输入由指针和长度给出（无需结束符），输出的UTF-8 Json分块写入handler而不返回字符串。
+// handler可能被调用多次，返回false时中止输出并报告异常。
+ALBC_API void RunWithJsonParamsTo(const char* json, size_t json_len, AlbcWriteHandler handler, void* user_data, ALBC_E_PTR);
+
+// 试算：输入同RunWithJsonParams，只筛选干员并划分互斥组，不枚举组合也不求解。
+// 返回各房间的组合数（列数）估计、保存组合及约束矩阵所需的内存，以及求解时将采用的策略（是否改用贪心、边际价值的计算方式）。
+ALBC_API String EstimateWithJsonParams(const char* json, ALBC_E_PTR);
+
+class ALBC_API_CLASS IBatchResult
+{
+  public:
+    // 获取该项的求解状态。0为正常，其他值出错。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual int GetStatus() const noexcept = 0;
+    // 获取求解输出，格式与RunWithJsonParams的返回值相同。出错时为"{}"。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual String GetOutput() const noexcept = 0;
+    // 获取出错信息，正常时为空字符串。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual String GetErrorMessage() const noexcept = 0;
+    // 获取该项从解析输入到生成输出的耗时，单位为秒。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual double GetElapsedSeconds() const noexcept = 0;
+    ALBC_API_MEMBER virtual ~IBatchResult() noexcept = default;
+
+    ALBC_MEM_DELEGATE
+};
+
+// 批量求解n份输入（格式同RunWithJsonParams）。整批共享同一份游戏数据快照，在内部线程池上并行求解，结果按输入顺序排列。
+// 单项出错只影响该项的状态，连结果对象都无法分配的项为空指针。并发数为thread_count，不超过线程池大小（硬件线程数），不大于0时使用线程池大小。
+// 返回的集合及其中的结果由调用者释放（delete集合即可）。
+ALBC_API ICollection<IBatchResult*>* RunBatchWithJsonParams(int n, const char* const* jsons, int thread_count, ALBC_E_PTR) noexcept;
+
 class ALBC_API_CLASS Character
 {
   public:
@@ -75,6 +104,10 @@ class ALBC_API_CLASS IRoomResult
     // 获取方案信息
     ALBC_NODISCARD ALBC_API_MEMBER virtual String GetReadableInfo() const noexcept = 0;
     ALBC_API_MEMBER virtual ~IRoomResult() noexcept = default;
+    // 以下为后续版本新增的接口，声明在析构函数之后以保持已有虚函数表的布局
+
+    // 获取该房间组合生成的统计项，名称同RunWithJsonParams输出中metrics.rooms下的键（如"combSeconds"、"calcCount"）。不存在时返回-1。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual double GetMetric(const char *name) const noexcept = 0;
 
     ALBC_MEM_DELEGATE
 };
@@ -87,6 +120,33 @@ class ALBC_API_CLASS IResult
     // 获取各个房间的生产方案。
     ALBC_NODISCARD ALBC_API_MEMBER virtual ICollection< IRoomResult* /* ref */ >* /* ref */ GetRoomDetails() const noexcept = 0;
     ALBC_API_MEMBER virtual ~IResult() noexcept = default;
+    // 以下为后续版本新增的接口，声明在析构函数之后以保持已有虚函数表的布局
+
+    // 获取备选方案，按总产能降序排列，不含最优方案本身。数量由ALBC_MODEL_PARAM_SOLUTION_POOL_SIZE决定。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual ICollection< IResult* /* ref */ >* /* ref */ GetAlternatives() const noexcept = 0;
+    // 获取干员的边际价值（移除该干员后总产能的减少量）。需设置ALBC_MODEL_PARAM_MARGINAL_VALUE_MODE，未计算时返回-1。
+    // 使用对偶价格估计时，被约束为必须上岗的干员不计算边际价值。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual double GetMarginalValue(const char *char_identifier) const noexcept = 0;
+    // 获取求解的统计项，名称同RunWithJsonParams输出中metrics下的键（如"cbcSeconds"、"nodes"、"gap"）。不存在时返回-1。
+    // 只有最优方案的结果带有统计，备选方案中各项均为0。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual double GetMetric(const char *name) const noexcept = 0;
+
+    ALBC_MEM_DELEGATE
+};
+
+class ALBC_API_CLASS IAsyncResult
+{
+  public:
+    // 求解是否已结束（完成、出错或已取消）。
+    ALBC_NODISCARD ALBC_API_MEMBER virtual bool IsReady() const noexcept = 0;
+    // 等待求解结束，最多等待timeout_seconds秒，小于0时一直等待。返回求解是否已结束。
+    ALBC_API_MEMBER virtual bool Wait(double timeout_seconds) const noexcept = 0;
+    // 请求取消求解。求解在下一个检查点停止，之后GetResult报告取消异常。
+    ALBC_API_MEMBER virtual void Cancel() noexcept = 0;
+    // 获取求解结果，求解未结束时阻塞等待。结果由调用者释放，只能获取一次。
+    ALBC_API_MEMBER virtual IResult *GetResult(ALBC_E_PTR) noexcept = 0;
+    // 释放时取消尚未结束的求解，并等待其退出。
+    ALBC_API_MEMBER virtual ~IAsyncResult() noexcept = default;
 
     ALBC_MEM_DELEGATE
 };
@@ -131,8 +191,18 @@ class ALBC_API_CLASS Model
 
     // 设置double类型的模型参数。
     ALBC_API_MEMBER void SetDblParam(AlbcModelParamType type, double value, ALBC_E_PTR) noexcept;
+    // 禁止指定标识符的干员参与排班。约束直接作用于已生成的组合，不会重新生成组合。
+    ALBC_API_MEMBER void ForbidCharacter(const char *char_identifier, ALBC_E_PTR) noexcept;
+    // 将指定标识符的干员固定在指定标识符的房间中。
+    ALBC_API_MEMBER void PinCharacter(const char *char_identifier, const char *room_identifier, ALBC_E_PTR) noexcept;
+    // 清除所有干员约束。
+    ALBC_API_MEMBER void ClearConstraints(ALBC_E_PTR) noexcept;
     // 对模型求解。
     ALBC_API_MEMBER IResult *GetResult(ALBC_E_PTR) noexcept;
+    // 在后台线程中对模型求解，返回可轮询、等待或取消的句柄。求解使用调用时的模型参数，
+    // 之后可以修改或释放模型；同一模型上的多次求解（同步或异步）依次执行。
+    // 不支持线程的构建中在本调用内同步求解，返回的句柄已就绪。
+    ALBC_API_MEMBER IAsyncResult *GetResultAsync(ALBC_E_PTR) noexcept;
 
     ALBC_PIMPL
     ALBC_MEM_DELEGATE
@@ -149,8 +219,12 @@ ALBC_API bool SetGlobalLocale(const char* locale) noexcept;
 // https://github.com/Kengxxiao/ArknightsGameData/blob/master/zh_CN/gamedata/excel/character_table.json
 // https://github.com/Kengxxiao/ArknightsGameData/blob/master/zh_CN/gamedata/excel/char_meta_table.json
 ALBC_API void LoadGameDataJson(AlbcGameDataDbType data_type, const char* json, ALBC_E_PTR);
+// 文件可以是JSON文本，也可以是由CompileGameDataSnapshot生成的二进制快照（自动识别）。
 ALBC_API void LoadGameDataFile(AlbcGameDataDbType data_type, const char* path, ALBC_E_PTR);
 
+// 将JSON格式的游戏数据文件编译为二进制快照，快照可直接传给LoadGameDataFile，加载时无需解析JSON文本。
+ALBC_API void CompileGameDataSnapshot(const char* json_path, const char* snapshot_path, ALBC_E_PTR);
+
 // 根据单个技能的ID或名称查询角色。支持提供角色ID或名称来进行更加精确的查询。
 // 需要初始化BuildingData。如果使用角色名字作为char_key，或则需要在查询结果中获取角色名字，还需初始化CharacterTable。
 ALBC_API ICharQuery* QueryChar(const char *skill_key, const char* char_key = nullptr);
@@ -182,6 +256,14 @@ ALBC_API AlbcTestMode ParseTestMode(const char *mode, AlbcTestMode default_mode,
 // 根据给定的游戏数据和玩家数据运行一次测试
 ALBC_API void RunTest(const char *game_data_json, const char *player_data_json, const AlbcTestConfig *config, ALBC_E_PTR);
 
+// 获取运行状态，每项为"键=值"形式的字符串：编译配置、已加载的游戏数据、缓存占用及进程内累计的求解统计。
+// 只读取已有状态，不触发数据加载，可供健康检查频繁调用。返回的集合由调用者释放。
 ALBC_API ICollection<String>* GetInfo(ALBC_E_PTR);
+
+// 设置RunWithJsonParams结果缓存的容量（条目数），设为0来禁用缓存。
+ALBC_API void SetResultCacheCapacity(int capacity, ALBC_E_PTR) noexcept;
+
+// 设置RunWithJsonParams结果缓存的磁盘目录，设为空指针或空字符串来禁用磁盘缓存。目录需已存在。
+ALBC_API void SetResultCacheDiskPath(const char* path, ALBC_E_PTR) noexcept;
 } // namespace albc
 #endif // ALBC_H
\ No newline at end of file
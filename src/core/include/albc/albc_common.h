@@ -5,6 +5,7 @@
 #ifndef _ALBC_COMMON_H_
 #define _ALBC_COMMON_H_
 #define _CRT_SECURE_NO_WARNINGS
+#include <stddef.h> // NOLINT(modernize-deprecated-headers)
 #ifndef __cplusplus
 #include <stdbool.h>
 #endif // __cplusplus
@@ -59,15 +60,25 @@ typedef enum AlbcTestMode
 {
     ALBC_TEST_MODE_ONCE = 0,
     ALBC_TEST_MODE_SEQUENTIAL = 1,
-    ALBC_TEST_MODE_PARALLEL = 2
+    ALBC_TEST_MODE_PARALLEL = 2,
+    ALBC_TEST_MODE_RELOAD = 3 // param个线程并发获取游戏数据，同时另一线程反复重新加载建筑数据
 } AlbcTestMode;
 
+typedef enum AlbcMarginalValueMode
+{
+    ALBC_MARGINAL_VALUE_NONE = 0,          // 不计算
+    ALBC_MARGINAL_VALUE_DUAL = 1,          // 由LP松弛的对偶价格估计，开销很小
+    ALBC_MARGINAL_VALUE_LEAVE_ONE_OUT = 2, // 逐个移除方案中的干员并行重新求解，结果精确
+} AlbcMarginalValueMode;
+
 typedef struct AlbcSolverParameters
 {
     bool gen_lp_file;
     bool gen_all_solution_details;
     double solve_time_limit;
     double model_time_limit;
+    int solution_pool_size; // 返回的方案数量（含最优方案），不大于1时只返回最优方案
+    AlbcMarginalValueMode marginal_value_mode; // 干员边际价值的计算方式
 } AlbcSolverParameters;
 
 typedef struct AlbcParameters
@@ -138,6 +149,8 @@ typedef enum AlbcModelParamType
 {
     ALBC_MODEL_PARAM_DURATION = 0,
     ALBC_MODEL_PARAM_SOLVE_TIME_LIMIT = 1,
+    ALBC_MODEL_PARAM_SOLUTION_POOL_SIZE = 2, // 返回的方案数量（含最优方案）
+    ALBC_MODEL_PARAM_MARGINAL_VALUE_MODE = 3, // 干员边际价值的计算方式，取值见AlbcMarginalValueMode
 } AlbcModelParamType;
 
 typedef enum AlbcRoomParamType
@@ -163,6 +176,8 @@ typedef enum AlbcGameDataDbType
 typedef bool (*AlbcLogHandler)(unsigned long logger_id, const char *message, void *user_data);
 typedef bool (*AlbcFlushLogHandler)(unsigned long logger_id, void *user_data);
 typedef void (*AlbcForEachCallback)(int i, const void *item, void *user_data);
+// output callback, receives size bytes starting at data (not null-terminated). return false to abort
+typedef bool (*AlbcWriteHandler)(const char *data, size_t size, void *user_data);
 
 #ifdef __cplusplus
 }
@@ -44,6 +44,27 @@ CALBC_API const char* AlbcStringGetContent(AlbcString* string);
  */
 CALBC_API AlbcString* AlbcRunWithJsonParams(const char* json, CALBC_E_PTR);
 
+// 与AlbcRunWithJsonParams相同，但输入由指针和长度给出（无需结束符），输出分块写入handler，不分配AlbcString。
+// handler可能被调用多次，调用者可在其中将数据追加到自己的可增长缓冲区；返回false时中止输出并报告异常。
+CALBC_API void AlbcRunWithJsonParamsTo(const char* json, size_t json_len, AlbcWriteHandler handler, void* user_data, CALBC_E_PTR);
+
+// 试算：输入同AlbcRunWithJsonParams，返回各房间的组合数、内存估计及求解时将采用的策略，不求解。
+CALBC_API AlbcString* AlbcEstimateWithJsonParams(const char* json, CALBC_E_PTR);
+
+// 批量求解的单项结果。output与error须由调用者使用AlbcStringDel释放
+typedef struct AlbcBatchResult
+{
+    int status;             // 0为正常，其他值出错
+    double elapsed_seconds; // 该项的求解耗时，单位为秒
+    AlbcString *output;     // 格式与AlbcRunWithJsonParams的返回值相同，出错时为"{}"
+    AlbcString *error;      // 出错信息，正常时为空字符串
+} AlbcBatchResult;
+
+// 批量求解n份输入（格式同AlbcRunWithJsonParams），结果按输入顺序写入out_results（须能容纳n项）。
+// 整批共享同一份游戏数据快照，在内部线程池上并行求解。thread_count不大于0时使用硬件线程数，且不超过线程池大小。
+// 结果对象都无法分配的项status非0，output与error为NULL。
+CALBC_API void AlbcRunBatchWithJsonParams(int n, const char* const* jsons, int thread_count, AlbcBatchResult* out_results, CALBC_E_PTR);
+
 
 // 设定输出字符串的编码。
 CALBC_API bool AlbcSetGlobalLocale(const char* locale);
@@ -63,6 +84,9 @@ CALBC_API void AlbcTest(const char *game_data_json, const char *player_data_json
 CALBC_API void AlbcLoadGameDataJson(AlbcGameDataDbType type, const char *json, CALBC_E_PTR);
 CALBC_API void AlbcLoadGameDataFile(AlbcGameDataDbType type, const char *path, CALBC_E_PTR);
 
+// 将JSON格式的游戏数据文件编译为二进制快照，快照可直接传给AlbcLoadGameDataFile
+CALBC_API void AlbcCompileGameDataSnapshot(const char *json_path, const char *snapshot_path, CALBC_E_PTR);
+
 // 设置全局日志等级。从ALL输出所有，到NONE不输出，将输出指定等级（包括）及以上等级的日志
 CALBC_API void AlbcSetLogLevel(AlbcLogLevel level, CALBC_E_PTR);
 
@@ -84,6 +108,12 @@ CALBC_API void AlbcSetLogHandler(AlbcLogHandler handler, void *user_data, CALBC_
 // 设置清空日志缓冲区的方式。设为空指针来还原成默认值。如果回调函数返回了false，则使用默认日志方式输出
 CALBC_API void AlbcSetFlushLogHandler(AlbcFlushLogHandler handler, void *user_data, CALBC_E_PTR);
 
+// 设置AlbcRunWithJsonParams结果缓存的容量（条目数），设为0来禁用缓存。
+CALBC_API void AlbcSetResultCacheCapacity(int capacity, CALBC_E_PTR);
+
+// 设置AlbcRunWithJsonParams结果缓存的磁盘目录，设为空指针或空字符串来禁用磁盘缓存。目录需已存在。
+CALBC_API void AlbcSetResultCacheDiskPath(const char* path, CALBC_E_PTR);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
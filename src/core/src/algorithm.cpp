@@ -3,15 +3,20 @@
 #include "util_time.h"
 #include "model_simulator.h"
 
+#include "CbcEventHandler.hpp"
 #include "CbcModel.hpp"
 #include "CoinModel.hpp"
+#include "CoinPackedVector.hpp"
 #include "OsiClpSolverInterface.hpp"
 
 #include <bitset>
 #include <fstream>
+#include <future>
 #include <numeric>
+#include <optional>
 #include <random>
 #include <regex>
+#include <sstream>
 #include <unordered_set>
 
 
@@ -55,21 +60,229 @@ class AlbcCoinMessageHandler : public CoinMessageHandler
 };
 
 static void ResolveSpCharGroup(const Vector<model::OperatorModel*>& ops,
-                               Dictionary<std::string, Vector<UInt32 /* index of op */  >>& group_ops_map)
+                               Dictionary<util::StringId, Vector<UInt32 /* index of op */  >>& group_ops_map)
 {
+    // 按驻留Id一遍分组，再去掉只有一个干员的组
     group_ops_map.clear();
-    std::unordered_multiset<size_t> group_ops_set;
-    for (const auto* op: ops)
-        if (!op->sp_char_group.empty())
-            group_ops_set.insert(std::hash<std::string>()(op->sp_char_group));
+    for (size_t i = 0; i < ops.size(); ++i)
+    {
+        if (ops[i]->sp_char_group_key == util::kEmptyStringId)
+            continue;
+
+        group_ops_map[ops[i]->sp_char_group_key].push_back(static_cast<UInt32>(i));
+    }
+
+    for (auto it = group_ops_map.begin(); it != group_ops_map.end();)
+    {
+        if (it->second.size() <= 1)
+            it = group_ops_map.erase(it);
+        else
+            ++it;
+    }
+}
+
+// 在Cbc的事件回调中检查取消标志，被取消时让Cbc停止分支定界
+class AlbcCbcCancelEventHandler : public CbcEventHandler
+{
+    const CancellationToken *token_;
+
+  public:
+    explicit AlbcCbcCancelEventHandler(const CancellationToken *token) : token_(token) {}
+
+    CbcAction event(CbcEvent) override
+    {
+        return token_ && token_->IsCancelled() ? stop : noAction;
+    }
+
+    [[nodiscard]] CbcEventHandler *clone() const override
+    {
+        return new AlbcCbcCancelEventHandler(*this);
+    }
+};
+
+// 求解已加载到solver中的整数规划模型，输出被选中的列。返回值为是否得到了可接受的解
+// initial_cols非空时作为初始可行解传给Cbc。cancel_token被设置时抛出OperationCancelledError
+// out_metrics非空时写入搜索的节点数与最终的相对间隙
+static bool SolveCbcModel(const OsiSolverInterface &solver, double time_limit, Vector<UInt32> &out_selected_cols,
+                          const Vector<UInt32> &initial_cols = {}, const CancellationToken *cancel_token = nullptr,
+                          SolveMetrics *out_metrics = nullptr)
+{
+    out_selected_cols.clear();
+    if (cancel_token)
+        cancel_token->ThrowIfCancelled();
+
+    auto message_handler = std::make_unique<AlbcCoinMessageHandler>();
+    CbcModel model(solver);
+    model.passInMessageHandler(message_handler.get());
+    if (cancel_token)
+    {
+        const AlbcCbcCancelEventHandler event_handler(cancel_token);
+        model.passInEventHandler(&event_handler); // Cbc保存的是副本
+    }
+    model.messageHandler()->setLogLevel(1);
+    model.setDblParam(CbcModel::CbcMaximumSeconds, time_limit);
+    model.setObjSense(-1);
+    model.initialSolve();
+    if (!initial_cols.empty())
+    {
+        const int n_cols = solver.getNumCols();
+        const double *obj = solver.getObjCoefficients();
+        Vector<double> initial_solution(n_cols, 0.);
+        double initial_obj = 0;
+        for (const UInt32 c : initial_cols)
+        {
+            initial_solution[c] = 1.;
+            initial_obj += obj[c];
+        }
+        model.setBestSolution(initial_solution.data(), n_cols, -initial_obj, true);
+    }
+    model.branchAndBound();
+    if (cancel_token)
+        cancel_token->ThrowIfCancelled();
+
+    if (out_metrics)
+        out_metrics->nodes = model.getNodeCount();
+
+    bool solution_accepted = false;
+    switch (model.status())
+    {
+    case 0:
+        // success
+        solution_accepted = true;
+        break;
+
+    case 1:
+        LOG_W("Solving terminated.");
+        if (model.secondaryStatus() == 4)
+        {
+            LOG_W("Solving time limit exceeded.");
+            solution_accepted = true;
+        }
+        else
+        {
+            LOG_W("Unrecognizable secondary status code: ", model.secondaryStatus());
+        }
+        break;
+
+    default:
+        LOG_E("Unrecognizable Cbc Model status code: ", model.status());
+        return false;
+    }
+
+    LOG_I("Solving finished. Optimal: ", model.isProvenOptimal());
+    LOG_I("Objective value: ", model.getObjValue());
 
+    if (!solution_accepted || std::abs(model.getMinimizationObjValue()) >= 1e50)
+        return false;
+
+    if (out_metrics)
+    {
+        const double obj = model.getObjValue();
+        out_metrics->gap = model.isProvenOptimal()
+                               ? 0.
+                               : std::abs(model.getBestPossibleObjValue() - obj) / std::max(std::abs(obj), 1e-10);
+    }
+
+    const auto solution_cols = static_cast<UInt32>(model.solver()->getNumCols());
+    const double *solution = model.solver()->getColSolution();
+    for (UInt32 c = 0; c < solution_cols; ++c)
+    {
+        if (!util::fp_eq(solution[c], 0.))
+            out_selected_cols.push_back(c);
+    }
+    return true;
+}
+
+// 基于LP松弛的对偶价格估计干员的边际价值：干员行的影子价格即为多提供一个该干员时总产能的增量。
+// 被约束为必须上岗的干员（行下界为1）的对偶价格包含了强制上岗的代价，不具有上述含义，因此不报告
+static void EstimateMarginalValuesByDual(const OsiClpSolverInterface &solver, const Vector<model::OperatorModel *> &ops,
+                                         size_t op_row_start, Dictionary<std::string, double> &out_values)
+{
+    const auto &sc = SCOPE_TIMER_WITH_TRACE("Estimating marginal values by LP duals");
+    OsiClpSolverInterface lp(solver);
+    for (int c = 0; c < lp.getNumCols(); ++c)
+        lp.setContinuous(c);
+
+    lp.setObjSense(-1);
+    lp.initialSolve();
+    if (!lp.isProvenOptimal())
+    {
+        LOG_W("LP relaxation is not optimal, marginal values are not available.");
+        return;
+    }
+
+    // Osi的对偶价格是目标函数（按其自身优化方向）对行右端项的导数，换算为总产能的增量
+    const double sense = lp.getObjSense();
+    const double *row_price = lp.getRowPrice();
+    const double *row_lb = lp.getRowLower();
     for (size_t i = 0; i < ops.size(); ++i)
     {
-        if (ops[i]->sp_char_group.empty()
-            || group_ops_set.count(std::hash<std::string>()(ops[i]->sp_char_group)) <= 1)
+        const size_t row = op_row_start + i;
+        if (row_lb[row] > 0.)
+        {
+            LOG_D("Skipping marginal value of pinned operator: ", ops[i]->identifier);
             continue;
+        }
+        out_values[ops[i]->identifier] = -sense * row_price[row];
+    }
+}
+
+// 逐个移除方案中的干员（将干员行上下界置0）后重新求解，以原方案去掉该干员所在组合作为初始解，得到精确的边际价值。
+// 被约束为必须上岗的干员同时放开其下界，其边际价值即为该约束所保留的产能
+static void EvaluateMarginalValuesByLeaveOneOut(
+    const OsiClpSolverInterface &solver, double time_limit, const Vector<UInt32> &selected_cols,
+    const Vector<std::tuple<const model::OperatorModel *, UInt32 /* op row */, UInt32 /* col */>> &selected_ops,
+    Dictionary<std::string, double> &out_values, const CancellationToken *cancel_token)
+{
+#ifdef ALBC_HAVE_THREADS
+    constexpr auto kLaunchPolicy = std::launch::async;
+#else
+    constexpr auto kLaunchPolicy = std::launch::deferred;
+#endif
+    const auto &sc = SCOPE_TIMER_WITH_TRACE("Evaluating marginal values by leave-one-out");
+    const double *obj = solver.getObjCoefficients();
+    double base_obj = 0;
+    for (const UInt32 c : selected_cols)
+        base_obj += obj[c];
+
+    Vector<std::optional<double>> deltas(selected_ops.size());
+    const auto evaluate = [&](size_t i) {
+        const auto &[op, op_row, op_col] = selected_ops[i];
+        OsiClpSolverInterface task_solver(solver);
+        task_solver.setRowBounds((int)op_row, 0., 0.);
+
+        Vector<UInt32> initial_cols;
+        std::copy_if(selected_cols.begin(), selected_cols.end(), std::back_inserter(initial_cols),
+                     [op_col = op_col](UInt32 c) { return c != op_col; });
+
+        Vector<UInt32> cols;
+        if (!SolveCbcModel(task_solver, time_limit, cols, initial_cols, cancel_token))
+        {
+            LOG_W("Unable to evaluate marginal value of operator: ", op->identifier);
+            return;
+        }
+
+        double new_obj = 0;
+        for (const UInt32 c : cols)
+            new_obj += obj[c];
+        deltas[i] = base_obj - new_obj;
+    };
 
-        group_ops_map[ops[i]->sp_char_group].push_back(static_cast<UInt32>(i));
+    const size_t concurrency = std::max(1U, std::thread::hardware_concurrency());
+    for (size_t begin = 0; begin < selected_ops.size(); begin += concurrency)
+    {
+        Vector<std::future<void>> futures;
+        for (size_t i = begin; i < std::min(begin + concurrency, selected_ops.size()); ++i)
+            futures.push_back(std::async(kLaunchPolicy, evaluate, i));
+
+        for (auto &f : futures)
+            f.get();
+    }
+
+    for (size_t i = 0; i < selected_ops.size(); ++i)
+    {
+        if (deltas[i])
+            out_values[std::get<0>(selected_ops[i])->identifier] = *deltas[i];
     }
 }
 
@@ -94,9 +307,9 @@ std::string SolutionData::ToString() const
         int n_buff = 1;
         for (const auto &buff : op->buffs)
         {
-            append_snprintf(p, size, "\tBuff #%d: %8s %s\n", n_buff, buff->name.c_str(),
-                            buff->buff_id.c_str());
-            append_snprintf(p, size, "\t%s\n", buff->description.c_str());
+            append_snprintf(p, size, "\tBuff #%d: %8s %s\n", n_buff, buff->GetName().c_str(),
+                            buff->GetBuffId().c_str());
+            append_snprintf(p, size, "\t%s\n", buff->GetDescription().c_str());
             append_snprintf(p, size, "\tMod:      %s\n\tFinal Mod:%s\n\tCost Mod: %s\n\n",
                             snapshot[n_op - 1][n_buff - 1].room_mod.to_string().c_str(),
                             snapshot[n_op - 1][n_buff - 1].final_mod.to_string().c_str(),
@@ -124,6 +337,14 @@ std::string IAlgorithm::GetSolutionInfo(const model::buff::RoomModel &room, cons
 template <typename TSolutionHolder>
 void CombMaker::MakeComb(const Vector<model::OperatorModel *> &operators, UInt32 max_n, model::buff::RoomModel *room,
                           TSolutionHolder &solution_holder)
+{
+    HardMutexResolver mutex_handler(operators, room->type);
+    MakeComb(operators, max_n, room, mutex_handler, solution_holder);
+}
+
+template <typename TSolutionHolder>
+void CombMaker::MakeComb(const Vector<model::OperatorModel *> &operators, UInt32 max_n, model::buff::RoomModel *room,
+                          HardMutexResolver &mutex_handler, TSolutionHolder &solution_holder)
 {
     if (room->max_slot_count <= 0)
     {
@@ -141,13 +362,9 @@ void CombMaker::MakeComb(const Vector<model::OperatorModel *> &operators, UInt32
     std::bitset<model::buff::kAlgOperatorSize> all_ops;
     all_ops.flip();
 
-    HardMutexResolver mutex_handler(operators, room->type);
-    auto calc_cnt = util::n_choose_k(static_cast<UInt32>(mutex_handler.non_mutex_ops.size()), max_n);
-    calc_cnt = std::max(calc_cnt, static_cast<UInt32>(1));
-    auto mutex_cnt = mutex_handler.MutexCombCnt();
-    calc_cnt += mutex_cnt * (util::n_choose_k(static_cast<UInt32>(mutex_handler.ops_for_partial_comb.size()), max_n) -
-                             calc_cnt); // 见MakePartialComb中防止重复计算部分
-    solution_holder.Reserve(calc_cnt);
+    RoomCombEstimate estimate;
+    mutex_handler.EstimateCombCnt(max_n, estimate);
+    solution_holder.Reserve(estimate.col_cnt);
 
     MakePartialComb(mutex_handler.non_mutex_ops, max_n, room, all_ops, solution_holder);
 
@@ -161,6 +378,55 @@ void CombMaker::MakeComb(const Vector<model::OperatorModel *> &operators, UInt32
     }
 }
 
+void CombMaker::Estimate(CombEstimate &out_estimate)
+{
+    // 约束矩阵的内存：Run中的三元组数组与列向量，加上Osi按列压缩保存的副本
+    static constexpr UInt64 kMatrixBytesPerCol = 2 * 3 * sizeof(double); // obj, col_lb, col_ub
+    static constexpr UInt64 kMatrixBytesPerNonzero = (sizeof(double) + 2 * sizeof(int)) + (sizeof(double) + sizeof(int));
+
+    out_estimate = {};
+    prepared_rooms_.clear();
+    prepared_rooms_.reserve(rooms_.size());
+    for (const auto room : rooms_)
+    {
+        const double filter_seconds = util::MeasureTime([&]() { this->FilterOperators(room); }).count();
+        auto &prepared = prepared_rooms_.emplace_back(
+            PreparedRoom{inbound_ops_, HardMutexResolver(inbound_ops_, room->type), filter_seconds});
+
+        auto &room_estimate = out_estimate.rooms[room->id];
+        room_estimate.inbound_ops = static_cast<UInt32>(inbound_ops_.size());
+        if (room->max_slot_count <= 0 || inbound_ops_.empty())
+            continue; // MakeComb不会生成组合
+
+        room_estimate.comb_size = std::min(static_cast<UInt32>(room->max_slot_count), room_estimate.inbound_ops);
+        prepared.mutex_handler.EstimateCombCnt(room_estimate.comb_size, room_estimate);
+
+        // 每列的非零元：所在房间行及组合中各干员的行
+        const UInt64 col_bytes = kMatrixBytesPerCol + (1 + room_estimate.comb_size) * kMatrixBytesPerNonzero;
+        room_estimate.solution_bytes = util::saturating_mul(room_estimate.col_cnt, sizeof(SolutionData));
+        room_estimate.matrix_bytes = util::saturating_mul(room_estimate.col_cnt, col_bytes);
+
+        out_estimate.col_cnt = util::saturating_add(out_estimate.col_cnt, room_estimate.col_cnt);
+        out_estimate.solution_bytes = util::saturating_add(out_estimate.solution_bytes, room_estimate.solution_bytes);
+        out_estimate.matrix_bytes = util::saturating_add(out_estimate.matrix_bytes, room_estimate.matrix_bytes);
+    }
+}
+
+HardMutexResolver CombMaker::PrepareRoom(size_t room_index, double &filter_seconds)
+{
+    auto *const room = rooms_[room_index];
+    if (room_index < prepared_rooms_.size())
+    {
+        auto &prepared = prepared_rooms_[room_index];
+        inbound_ops_ = std::move(prepared.inbound_ops);
+        filter_seconds = prepared.filter_seconds;
+        return std::move(prepared.mutex_handler);
+    }
+
+    filter_seconds = util::MeasureTime([&]() { this->FilterOperators(room); }).count();
+    return {inbound_ops_, room->type};
+}
+
 void IAlgorithm::FilterOperators(const model::buff::RoomModel *room)
 {
     inbound_ops_.clear();
@@ -199,7 +465,7 @@ ALBC_FLATTEN void CombMaker::MakePartialComb(const Vector<model::OperatorModel *
 
     auto size = static_cast<UInt32>(operators.size());
     max_n = std::min(size, max_n);
-    UInt32 calc_cnt = 0;
+    UInt64 calc_cnt = 0;
 
     // 栈变量，用于模拟递归栈
     UInt32 pos[kRoomMaxBuffSlots]{};      // 第i层递归选中干员的位置
@@ -225,6 +491,9 @@ ALBC_FLATTEN void CombMaker::MakePartialComb(const Vector<model::OperatorModel *
     double max_duration = params_.model_time_limit;
     bool is_all_ops = enabled_root_ops.all();
 
+    // 每计算kCancelCheckInterval个组合检查一次取消标志
+    static constexpr UInt32 kCancelCheckInterval = 4096;
+
     UInt32 dep = 0; // 当dep==max_n-1时，得到一个组合
     while (true)
     {
@@ -248,7 +517,9 @@ ALBC_FLATTEN void CombMaker::MakePartialComb(const Vector<model::OperatorModel *
 
                 if (dep >= max_n - 1)
                 {
-                    ++calc_cnt;
+                    if (++calc_cnt % kCancelCheckInterval == 0)
+                        ThrowIfCancelled();
+
                     double result, duration;
                     Simulator::DoCalc(room, max_duration, result, duration);
                     solution_holder.OnSolutionFound(current, result, duration);
@@ -282,7 +553,7 @@ ALBC_FLATTEN void CombMaker::MakePartialComb(const Vector<model::OperatorModel *
         }
     }
 
-    solution_holder.UpdateCalcCnt(calc_cnt);
+    solution_holder.AddCalcCnt(calc_cnt);
 }
 
 void CombMaker::Run(AlgorithmResult &result)
@@ -296,9 +567,9 @@ void CombMaker::Run(AlgorithmResult &result)
     GreedySolutionHolder solution_holder;
 
     // measures the time of MakeComb()
-    const double elapsedSec = util::MeasureTime(&CombMaker::MakeComb<GreedySolutionHolder>, this, inbound_ops_,
-                                          room->max_slot_count, room, solution_holder)
-                                  .count();
+    const double elapsedSec = util::MeasureTime([&]() {
+                                  this->MakeComb(inbound_ops_, room->max_slot_count, room, solution_holder);
+                              }).count();
 
     // prints the number of calculations
     LOG_D("calc cnt: ", solution_holder.calc_cnt);
@@ -327,10 +598,10 @@ HardMutexResolver::HardMutexResolver(const Vector<model::OperatorModel *> &ops,
     // 用于处理不能同时生效的Buff和异格干员
     static constexpr size_t buff_type_cnt = util::enum_size<model::buff::RoomBuffType>::value;
     UInt32 buff_type_mutex_group_map[buff_type_cnt];
-    Dictionary<std::string /*sp_char_group*/, UInt32> sp_char_group_mutex_group_map;
+    Dictionary<util::StringId /*sp_char_group*/, UInt32> sp_char_group_mutex_group_map;
     std::fill_n(buff_type_mutex_group_map, buff_type_cnt, UINT32_MAX);
 
-    Dictionary<std::string, Vector<UInt32>> sp_char_group_map;
+    Dictionary<util::StringId, Vector<UInt32>> sp_char_group_map;
     ResolveSpCharGroup(ops, sp_char_group_map);
 
     for (const auto& [sp_char_group, op_indices] : sp_char_group_map)
@@ -368,7 +639,7 @@ HardMutexResolver::HardMutexResolver(const Vector<model::OperatorModel *> &ops,
                     if (op_is_mutex)
                     {
                         LOG_E("Logic error: operator ", op->char_id, " has more than one mutex buff or operator is SP char! "
-                                                                     "The buff: ", buff->buff_id, " will be ignored");
+                                                                     "The buff: ", buff->GetBuffId(), " will be ignored");
                         continue;
                     }
 
@@ -440,10 +711,35 @@ bool HardMutexResolver::HasMutexBuff() const
 {
     return !mutex_groups_.empty();
 }
-UInt32 HardMutexResolver::MutexCombCnt() const
+UInt64 HardMutexResolver::MutexCombCnt() const
 {
-    return std::accumulate(mutex_groups_.begin(), mutex_groups_.end(), 1,
-                           [](UInt32 sum, const Vector<model::OperatorModel *> &group) { return sum * static_cast<UInt32>(group.size()); });
+    return std::accumulate(mutex_groups_.begin(), mutex_groups_.end(), static_cast<UInt64>(1),
+                           [](UInt64 product, const Vector<model::OperatorModel *> &group) {
+                               return util::saturating_mul(product, group.size());
+                           });
+}
+void HardMutexResolver::EstimateCombCnt(UInt32 max_n, RoomCombEstimate &out_estimate) const
+{
+    // 与CombMaker::MakeComb的枚举过程一一对应：先枚举非互斥干员的组合，
+    // 再对每种互斥取法枚举至少包含一个互斥组代表的组合，每次MakePartialComb的组合大小不超过其干员数
+    const auto non_mutex_cnt = static_cast<UInt32>(non_mutex_ops.size());
+    const auto partial_cnt = static_cast<UInt32>(ops_for_partial_comb.size());
+
+    out_estimate.mutex_groups = MutexGroupCnt();
+    out_estimate.base_comb_cnt = non_mutex_cnt > 0 ? util::n_choose_k(non_mutex_cnt, std::min(non_mutex_cnt, max_n)) : 0;
+    out_estimate.mutex_comb_cnt = 0;
+    out_estimate.partial_comb_cnt = 0;
+    if (HasMutexBuff())
+    {
+        const UInt32 partial_n = std::min(partial_cnt, max_n);
+        const UInt64 all_comb_cnt = util::n_choose_k(partial_cnt, partial_n);
+        out_estimate.mutex_comb_cnt = MutexCombCnt();
+        out_estimate.partial_comb_cnt =
+            all_comb_cnt == UINT64_MAX ? UINT64_MAX : all_comb_cnt - util::n_choose_k(non_mutex_cnt, partial_n);
+    }
+
+    const UInt64 mutex_col_cnt = util::saturating_mul(out_estimate.mutex_comb_cnt, out_estimate.partial_comb_cnt);
+    out_estimate.col_cnt = util::saturating_add(out_estimate.base_comb_cnt, mutex_col_cnt);
 }
 UInt32 HardMutexResolver::MutexGroupCnt() const
 {
@@ -497,11 +793,20 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
     Vector<Vector<SolutionData>> room_solutions;
     Vector<UInt32> room_ranges;
     UInt32 total_solution_count = 0;
-    GenCombForRooms(room_solutions, room_ranges, total_solution_count);
+    auto &metrics = out_result.metrics;
+    if (session_)
+        session_->BeginSolve();
+
+    metrics.comb_seconds = util::MeasureTime([&]() {
+        GenCombForRooms(room_solutions, room_ranges, total_solution_count, metrics);
+    }).count();
+    const auto matrix_start = util::PerfClock::now();
 
     if (total_solution_count < 1)
     {
         LOG_W("No solution!");
+        if (session_)
+            session_->EndSolve(room_keys_, room_ranges, {});
         return;
     }
 
@@ -541,7 +846,7 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
     UInt32 sp_op_elem_cnt = 0;
     Vector<UInt32> op_row_to_sp_group_row_map(all_ops_.size(), UINT32_MAX);
     {
-        Dictionary<std::string, Vector<UInt32>> sp_char_group_map;
+        Dictionary<util::StringId, Vector<UInt32>> sp_char_group_map;
         ResolveSpCharGroup(all_ops_, sp_char_group_map);
         auto sp_group_row_start_idx = row_range_map[RowType::ROOM_CONS].End();
         sp_group_cnt = static_cast<UInt32>(sp_char_group_map.size());
@@ -632,11 +937,15 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
         }
     }
 
+    if (constraints_ && !constraints_->Empty())
+    {
+        ApplyConstraints(room_solutions, op_inst_id_to_op_row_map, col_ub, row_lb);
+    }
+
     LOG_D("Inserted ", elem_cnt, " elements out of ", elem_reserve_cnt, " reserved.");
     LOG_I("Solving using Cbc solver");
     {
         const auto &sc = SCOPE_TIMER_WITH_TRACE("Solving using Cbc solver");
-        auto message_handler = std::make_unique<AlbcCoinMessageHandler>();
         OsiClpSolverInterface solver;
         solver.setHintParam(OsiDoReducePrint, true, OsiHintTry);
 
@@ -645,54 +954,29 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
         for (int c = 0; c < (int)col_cnt; ++c)
             solver.setInteger(c);
 
-        CbcModel model(solver);
-        model.passInMessageHandler(message_handler.get());
-        model.messageHandler()->setLogLevel(1);
-        model.setDblParam(CbcModel::CbcMaximumSeconds, params_.solve_time_limit);
-        model.setObjSense(-1);
-        model.initialSolve();
-        model.branchAndBound();
-
-        bool solution_accepted = false;
-        switch (model.status())
+        Vector<UInt32> selected_cols;
+        Vector<UInt32> warm_start_cols;
+        if (session_)
         {
-        case 0:
-            // success
-            solution_accepted = true;
-            break;
-
-        case 1:
-            LOG_W("Solving terminated.");
-            if (model.secondaryStatus() == 4)
-            {
-                LOG_W("Solving time limit exceeded.");
-                solution_accepted = true;
-            }
-            else
-            {
-                LOG_W("Unrecognizable secondary status code: ", model.secondaryStatus());
-            }
-            break;
-
-        default:
-            LOG_E("Unrecognizable Cbc Model status code: ", model.status());
-            return;
+            warm_start_cols = session_->GetWarmStartCols(room_keys_, room_ranges);
+            LOG_D("Warm starting with ", warm_start_cols.size(), " columns from previous solution.");
         }
 
-        LOG_I("Solving finished. Optimal: ", model.isProvenOptimal());
-        LOG_I("Objective value: ", model.getObjValue());
-
-        if (solution_accepted && std::abs(model.getMinimizationObjValue()) < 1e50)
+        metrics.matrix_seconds = util::FloatingSeconds(util::PerfClock::now() - matrix_start).count();
+        metrics.col_cnt = col_cnt;
+        metrics.row_cnt = row_cnt;
+        metrics.nonzero_cnt = elem_cnt;
+
+        bool solved = false;
+        metrics.cbc_seconds = util::MeasureTime([&]() {
+            solved = SolveCbcModel(solver, params_.solve_time_limit, selected_cols, warm_start_cols, cancel_token_,
+                                   &metrics);
+        }).count();
+        if (solved)
         {
-            UInt32 solution_cols = model.solver()->getNumCols();
-            const double *solution = model.solver()->getColSolution();
-
             // print overall solution info
-            for (UInt32 c = 0; c < solution_cols; ++c)
+            for (const UInt32 c : selected_cols)
             {
-                if (util::fp_eq(solution[c], 0.))
-                    continue;
-
                 UInt32 room_idx = GetRoomIdx(c, room_ranges);
                 UInt32 sol_idx_in_room = GetIndexInRoom(c, room_ranges);
                 char buf[128];
@@ -716,34 +1000,77 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
             }
 
             // print solution details
-            for (UInt32 c = 0; c < solution_cols; ++c)
+            for (const UInt32 c : selected_cols)
             {
-                if (util::fp_eq(solution[c], 0.))
-                    continue;
-
                 UInt32 room = GetRoomIdx(c, room_ranges);
                 UInt32 sol_idx_in_room = GetIndexInRoom(c, room_ranges);
                 LOG_D("***** Solution: col#", c, " at room#", room, " index#", sol_idx_in_room, " *****");
                 LOG_D(GetSolutionInfo(*rooms_[room], room_solutions[room][sol_idx_in_room]));
             }
 
-            for (UInt32 c = 0; c < solution_cols; ++c)
+            CollectRoomResults(selected_cols, room_solutions, room_ranges, out_result.rooms);
+        }
+
+        if (session_)
+            session_->EndSolve(room_keys_, room_ranges, selected_cols);
+
+        const auto marginal_values_start = util::PerfClock::now();
+        switch (params_.marginal_value_mode)
+        {
+        case ALBC_MARGINAL_VALUE_DUAL:
+            EstimateMarginalValuesByDual(solver, all_ops_, row_range_map[RowType::OP_CONS].start,
+                                         out_result.marginal_values);
+            break;
+
+        case ALBC_MARGINAL_VALUE_LEAVE_ONE_OUT: {
+            // 未被选中的干员移除后最优解不变，边际价值为0
+            for (const auto *op : all_ops_)
+                out_result.marginal_values[op->identifier] = 0;
+
+            Vector<std::tuple<const model::OperatorModel *, UInt32, UInt32>> selected_ops;
+            for (const UInt32 c : selected_cols)
             {
-                if (util::fp_eq(solution[c], 0.))
-                    continue;
+                const auto &solution = room_solutions[GetRoomIdx(c, room_ranges)][GetIndexInRoom(c, room_ranges)];
+                for (const auto *op : solution.operators)
+                {
+                    if (op)
+                        selected_ops.emplace_back(op, op_inst_id_to_op_row_map[op->inst_id], c);
+                }
+            }
+            EvaluateMarginalValuesByLeaveOneOut(solver, params_.solve_time_limit, selected_cols, selected_ops,
+                                                out_result.marginal_values, cancel_token_);
+            break;
+        }
 
-                UInt32 room = GetRoomIdx(c, room_ranges);
-                UInt32 sol_idx_in_room = GetIndexInRoom(c, room_ranges);
-                auto &room_result = out_result.rooms.emplace_back();
-                room_result.room = rooms_[room];
-                room_result.solution = room_solutions[room][sol_idx_in_room];
+        default:
+            break;
+        }
+        metrics.marginal_values_seconds = util::FloatingSeconds(util::PerfClock::now() - marginal_values_start).count();
+
+        // 备选方案：在已建立的矩阵上逐次加入no-good割平面（Σx <= |S| - 1）排除已得到的方案后重新求解，不重新生成组合
+        const auto alternatives_start = util::PerfClock::now();
+        for (int k = 1; k < params_.solution_pool_size && !selected_cols.empty(); ++k)
+        {
+            CoinPackedVector cut;
+            for (const UInt32 c : selected_cols)
+                cut.insert((int)c, 1.);
+            solver.addRow(cut, -solver.getInfinity(), static_cast<double>(selected_cols.size()) - 1.);
+
+            if (!SolveCbcModel(solver, params_.solve_time_limit, selected_cols, {}, cancel_token_) || selected_cols.empty())
+            {
+                LOG_I("No more alternative solutions, found ", k - 1, " alternatives.");
+                break;
             }
+
+            CollectRoomResults(selected_cols, room_solutions, room_ranges, out_result.alternatives.emplace_back());
         }
+        metrics.alternatives_seconds = util::FloatingSeconds(util::PerfClock::now() - alternatives_start).count();
     }
 
     if (params_.gen_lp_file)
     {
-        GenLpFile(room_solutions, obj, row_cnt, col_cnt, elems, row_indices, col_indices, row_range_map, row_ub);
+        GenLpFile(room_solutions, obj, row_cnt, col_cnt, elems, row_indices, col_indices, row_range_map, row_lb, row_ub,
+                  col_ub);
     }
 
     if (params_.gen_all_solution_details)
@@ -753,36 +1080,74 @@ void MultiRoomIntegerProgramming::Run(AlgorithmResult &out_result)
 }
 
 void MultiRoomIntegerProgramming::GenCombForRooms(Vector<Vector<SolutionData>> &room_solutions,
-                                                  Vector<UInt32> &room_ranges, UInt32 &col_cnt)
+                                                  Vector<UInt32> &room_ranges, UInt32 &col_cnt,
+                                                  SolveMetrics &metrics)
 {
     const auto &sc = SCOPE_TIMER_WITH_TRACE("Generating combinations");
-    for (auto room : this->rooms_)
+    room_keys_.clear();
+    for (size_t room_index = 0; room_index < this->rooms_.size(); ++room_index)
     {
-        this->FilterOperators(room);
+        ThrowIfCancelled();
+        auto *const room = this->rooms_[room_index];
+        auto &room_metrics = metrics.rooms[room->id];
+        auto mutex_handler = PrepareRoom(room_index, room_metrics.filter_seconds);
+        room_metrics.inbound_ops = static_cast<UInt32>(inbound_ops_.size());
         if (inbound_ops_.empty())
         {
             LOG_W("No inbound operators for room#", room->id);
         }
 
-        AllSolutionHolder solution_holder;
-        this->MakeComb(this->inbound_ops_, room->max_slot_count, room, solution_holder);
+        Vector<SolutionData> solutions;
+        SolveSession::BlockSignature signature;
+        SolveSession::BlockKey key = 0;
+        bool is_cached = false;
+        if (session_)
+        {
+            signature = SolveSession::MakeBlockSignature(*room, inbound_ops_, all_ops_, params_.model_time_limit);
+            key = SolveSession::MakeBlockKey(signature);
+            room_keys_.push_back(key);
+            is_cached = session_->TryGetColumns(key, signature, inbound_ops_, solutions);
+        }
+
+        if (is_cached)
+        {
+            LOG_D("Reusing ", solutions.size(), " cached combinations for room#", room->id);
+        }
+        else
+        {
+            AllSolutionHolder solution_holder;
+            room_metrics.comb_seconds = util::MeasureTime([&]() {
+                this->MakeComb(this->inbound_ops_, room->max_slot_count, room, mutex_handler, solution_holder);
+            }).count();
+            room_metrics.calc_cnt = solution_holder.calc_cnt;
+            metrics.calc_cnt += solution_holder.calc_cnt;
+            solution_holder.solutions.resize(solution_holder.sol_cnt); // 预留的空间与实际组合数一致，仅作防护
+            solutions = std::move(solution_holder.solutions);
+
+            if (session_)
+                session_->StoreColumns(key, signature, inbound_ops_, solutions);
+        }
 
-        if (solution_holder.solutions.empty())
+        if (solutions.empty())
         {
             LOG_W("No solution for room ", room->id);
         }
 
+        room_metrics.cached = is_cached;
+        room_metrics.col_cnt = static_cast<UInt32>(solutions.size());
         room_ranges.push_back(col_cnt);
-        col_cnt += static_cast<UInt32>(solution_holder.solutions.size());
-        room_solutions.emplace_back(std::move(solution_holder.solutions));
+        col_cnt += static_cast<UInt32>(solutions.size());
+        room_solutions.emplace_back(std::move(solutions));
     }
+    prepared_rooms_.clear();
     LOG_I("Generated ", col_cnt, " combinations.");
 }
 
 void MultiRoomIntegerProgramming::GenLpFile(Vector<Vector<SolutionData>> &room_solutions, const Vector<double> &obj,
                                             UInt32 row_cnt, UInt32 col_cnt, const Vector<double> &elems,
                                             const Vector<int> &row_indices, Vector<int> &col_indices,
-                                            const RowRangeMap& ranges, const Vector<double> &row_ub) const
+                                            const RowRangeMap& ranges, const Vector<double> &row_lb,
+                                            const Vector<double> &row_ub, const Vector<double> &col_ub) const
 {
     const auto lp_file_path = "./problem.lp";
     const auto &sc = SCOPE_TIMER_WITH_TRACE("Writing LP File");
@@ -861,7 +1226,9 @@ void MultiRoomIntegerProgramming::GenLpFile(Vector<Vector<SolutionData>> &room_s
     lp_file << "\nSubject To\n";
     for (UInt32 r = 0; r < row_cnt; r++)
     {
-        bool has_constraint = false;
+        if (row_elems[r].empty())
+            continue;
+
         std::string row_name;
         size_t row_index_in_type;
         switch(ranges.GetType(r, row_index_in_type))
@@ -883,36 +1250,53 @@ void MultiRoomIntegerProgramming::GenLpFile(Vector<Vector<SolutionData>> &room_s
             break;
         }
 
+        std::ostringstream row_expr;
         for (const auto &[c, elem] : row_elems[r])
         {
-            if (!has_constraint)
-            {
-                lp_file << " "
-                        << row_name
-                        << ": ";
-                has_constraint = true;
-            }
-            else
+            if (row_expr.tellp() > 0)
             {
-                lp_file << " + ";
+                row_expr << " + ";
             }
 
             if (!util::fp_eq(elem, 1.))
             {
-                lp_file << elem << col_name_map[c];
+                row_expr << elem << col_name_map[c];
             }
             else
             {
-                lp_file << col_name_map[c];
+                row_expr << col_name_map[c];
             }
         }
 
-        if (has_constraint)
+        // 固定干员的行下界为1，与上界相等时写为等式，否则另写一行下界约束
+        if (util::fp_eq(row_lb[r], row_ub[r]))
         {
-            lp_file << " <= " << row_ub[r] << "\n";
+            lp_file << " " << row_name << ": " << row_expr.str() << " = " << row_ub[r] << "\n";
+            continue;
+        }
+
+        lp_file << " " << row_name << ": " << row_expr.str() << " <= " << row_ub[r] << "\n";
+        if (row_lb[r] > 0.)
+        {
+            lp_file << " " << row_name << "_lb: " << row_expr.str() << " >= " << row_lb[r] << "\n";
         }
     }
 
+    // 被干员约束排除的组合上界为0
+    bool has_bounds = false;
+    for (UInt32 c = 0; c < col_cnt; c++)
+    {
+        if (col_ub[c] >= 1.)
+            continue;
+
+        if (!has_bounds)
+        {
+            lp_file << "Bounds\n";
+            has_bounds = true;
+        }
+        lp_file << " " << col_name_map[c] << " = " << col_ub[c] << "\n";
+    }
+
     lp_file << "Binary\n";
     for (UInt32 i = 0; i < col_cnt; i++)
     {
@@ -981,4 +1365,100 @@ UInt32 MultiRoomIntegerProgramming::GetIndexInRoom(UInt32 col, const Vector<UInt
 {
     return col - room_ranges[GetRoomIdx(col, room_ranges)];
 }
+void MultiRoomIntegerProgramming::ApplyConstraints(const Vector<Vector<SolutionData>> &room_solutions,
+                                                   const Vector<UInt32> &op_inst_id_to_op_row_map,
+                                                   Vector<double> &col_ub, Vector<double> &row_lb) const
+{
+    // 禁用干员：包含该干员的列上界置0
+    // 固定干员：指定房间中不包含该干员的列、其他房间中包含该干员的列上界置0，并将该干员行的下界置1
+    std::bitset<model::buff::kAlgOperatorSize> forbidden_ops;
+    for (const auto *op : all_ops_)
+    {
+        if (constraints_->forbidden_ops.count(op->identifier))
+            forbidden_ops.set(op->inst_id);
+    }
+
+    Vector<std::pair<const model::OperatorModel *, UInt32 /* room idx */>> pins;
+    for (const auto &[op_ident, room_ident] : constraints_->pinned_ops)
+    {
+        const auto op_it = std::find_if(all_ops_.begin(), all_ops_.end(),
+                                        [&op_ident = op_ident](const auto *op) { return op->identifier == op_ident; });
+        const auto room_it = std::find_if(rooms_.begin(), rooms_.end(),
+                                          [&room_ident = room_ident](const auto *room) { return room->id == room_ident; });
+        if (op_it == all_ops_.end() || room_it == rooms_.end())
+        {
+            LOG_W("Ignoring pin constraint: ", op_ident, " -> ", room_ident, ", operator or room not found.");
+            continue;
+        }
+
+        if (forbidden_ops[(*op_it)->inst_id])
+        {
+            LOG_W("Ignoring pin constraint: ", op_ident, " -> ", room_ident, ", operator is forbidden.");
+            continue;
+        }
+
+        pins.emplace_back(*op_it, static_cast<UInt32>(room_it - rooms_.begin()));
+    }
+
+    Vector<bool> pin_satisfiable(pins.size(), false);
+    UInt32 c = 0;
+    UInt32 masked_cnt = 0;
+    for (UInt32 room_idx = 0; room_idx < room_solutions.size(); ++room_idx)
+    {
+        for (const auto &solution : room_solutions[room_idx])
+        {
+            bool enabled = std::none_of(solution.operators.begin(), solution.operators.end(),
+                                        [&forbidden_ops](const auto *op) { return op && forbidden_ops[op->inst_id]; });
+
+            for (const auto &[pin_op, pin_room_idx] : pins)
+            {
+                const bool contains_op = std::find(solution.operators.begin(), solution.operators.end(), pin_op) !=
+                                         solution.operators.end();
+                if (contains_op != (room_idx == pin_room_idx))
+                    enabled = false;
+            }
+
+            if (enabled)
+            {
+                for (size_t i = 0; i < pins.size(); ++i)
+                {
+                    if (pins[i].second == room_idx)
+                        pin_satisfiable[i] = true;
+                }
+            }
+            else
+            {
+                col_ub[c] = 0;
+                ++masked_cnt;
+            }
+            ++c;
+        }
+    }
+
+    for (size_t i = 0; i < pins.size(); ++i)
+    {
+        const auto *op = pins[i].first;
+        if (pin_satisfiable[i])
+            row_lb[op_inst_id_to_op_row_map[op->inst_id]] = 1;
+        else
+            LOG_W("Pin constraint for operator ", op->identifier, " cannot be satisfied in room ",
+                  rooms_[pins[i].second]->id, ", the operator will not be assigned.");
+    }
+
+    LOG_I("Applied operator constraints: masked ", masked_cnt, " of ", c, " combinations.");
+}
+void MultiRoomIntegerProgramming::CollectRoomResults(const Vector<UInt32> &selected_cols,
+                                                     const Vector<Vector<SolutionData>> &room_solutions,
+                                                     const Vector<UInt32> &room_ranges,
+                                                     Vector<RoomResult> &out_rooms) const
+{
+    for (const UInt32 c : selected_cols)
+    {
+        UInt32 room = GetRoomIdx(c, room_ranges);
+        UInt32 sol_idx_in_room = GetIndexInRoom(c, room_ranges);
+        auto &room_result = out_rooms.emplace_back();
+        room_result.room = rooms_[room];
+        room_result.solution = room_solutions[room][sol_idx_in_room];
+    }
+}
 } // namespace albc::algorithm
\ No newline at end of file
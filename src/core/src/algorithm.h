@@ -2,6 +2,7 @@
 
 #include "albc/calbc.h"
 #include "algorithm_params.h"
+#include "algorithm_session.h"
 #include <bitset>
 
 namespace albc::algorithm
@@ -17,25 +18,32 @@ class IAlgorithm
   public:
     virtual ~IAlgorithm() = default;
 
-    IAlgorithm(const Vector<model::buff::RoomModel *> &rooms, const mem::PtrVector<model::OperatorModel> &operators,
+    IAlgorithm(const Vector<model::buff::RoomModel *> &rooms, const Vector<model::OperatorModel *> &operators,
               const AlbcSolverParameters &params)
-        : rooms_(rooms), all_ops_(mem::unwrap_ptr_vector(operators)), params_(params)
-    {
-    }
-
-    IAlgorithm(const mem::PtrVector<model::buff::RoomModel> &rooms, const mem::PtrVector<model::OperatorModel> &operators,
-              const AlbcSolverParameters &params)
-        : IAlgorithm(mem::unwrap_ptr_vector(rooms), operators, params)
+        : rooms_(rooms), all_ops_(operators), params_(params)
     {
     }
 
     virtual void Run(AlgorithmResult &result) = 0; // 实现算法
 
+    // 设置取消标志，被取消时Run抛出OperationCancelledError
+    void SetCancellationToken(const CancellationToken *token) { cancel_token_ = token; }
+
+    // 替换求解参数，须在Run之前调用
+    void SetSolverParameters(const AlbcSolverParameters &params) { params_ = params; }
+
   protected:
     Vector<model::buff::RoomModel *> rooms_;
     Vector<model::OperatorModel *> all_ops_;
     Vector<model::OperatorModel *> inbound_ops_;
     AlbcSolverParameters params_;
+    const CancellationToken *cancel_token_ = nullptr;
+
+    void ThrowIfCancelled() const
+    {
+        if (cancel_token_)
+            cancel_token_->ThrowIfCancelled();
+    }
 
     void FilterOperators(const model::buff::RoomModel *room);
 
@@ -53,9 +61,12 @@ class HardMutexResolver
     HardMutexResolver(const Vector<model::OperatorModel *> &ops, data::building::RoomType room_type);
     [[nodiscard]] bool MoveNext();
     [[nodiscard]] bool HasMutexBuff() const;
-    [[nodiscard]] UInt32 MutexCombCnt() const;
+    [[nodiscard]] UInt64 MutexCombCnt() const;
     [[nodiscard]] UInt32 MutexGroupCnt() const;
 
+    // 计算以max_n个干员为一组时MakeComb生成的组合数，填充out_estimate中的组合数各项
+    void EstimateCombCnt(UInt32 max_n, RoomCombEstimate &out_estimate) const;
+
   protected:
     Vector<Vector<model::OperatorModel *>> mutex_groups_;
     Vector<UInt32> group_pos_;
@@ -66,9 +77,25 @@ class CombMaker : public IAlgorithm
   public:
     void Run(AlgorithmResult &result) override;
 
+    // 只筛选干员并划分互斥组，估计各房间生成的组合数及内存占用，不枚举组合
+    // 筛选结果保留到之后的Run中使用，Run不再重复筛选
+    void Estimate(CombEstimate &out_estimate);
+
   protected:
     using IAlgorithm::IAlgorithm;
 
+    // Estimate中各房间筛选后的干员及互斥组
+    struct PreparedRoom
+    {
+        Vector<model::OperatorModel *> inbound_ops;
+        HardMutexResolver mutex_handler;
+        double filter_seconds = 0;
+    };
+    Vector<PreparedRoom> prepared_rooms_; // 为空或与rooms_一一对应
+
+    // 筛选干员到inbound_ops_，Estimate已筛选过时直接取用其结果。返回房间的互斥组划分
+    [[nodiscard]] HardMutexResolver PrepareRoom(size_t room_index, double &filter_seconds);
+
     template <typename TSolutionHolder>
     void MakePartialComb(const Vector<model::OperatorModel *> &operators, UInt32 max_n, model::buff::RoomModel *room,
                          const std::bitset<model::buff::kAlgOperatorSize> &enabled_root_ops, TSolutionHolder &solution_holder) const;
@@ -76,6 +103,11 @@ class CombMaker : public IAlgorithm
     template <typename TSolutionHolder>
     void MakeComb(const Vector<model::OperatorModel *> &operators, UInt32 max_n, model::buff::RoomModel *room,
                   TSolutionHolder &solution_holder);
+
+    // mutex_handler须由operators构造且未被枚举过
+    template <typename TSolutionHolder>
+    void MakeComb(const Vector<model::OperatorModel *> &operators, UInt32 max_n, model::buff::RoomModel *room,
+                  HardMutexResolver &mutex_handler, TSolutionHolder &solution_holder);
 };
 
 class MultiRoomGreedy : public CombMaker
@@ -98,7 +130,17 @@ class MultiRoomIntegerProgramming : public CombMaker
 
     void Run(AlgorithmResult &out_result) override;
 
+    // 设置求解会话，用于在多次求解之间复用各房间的组合
+    void SetSession(SolveSession *session) { session_ = session; }
+
+    // 设置干员约束
+    void SetConstraints(const OperatorConstraints *constraints) { constraints_ = constraints; }
+
   protected:
+    SolveSession *session_ = nullptr;
+    const OperatorConstraints *constraints_ = nullptr;
+    Vector<SolveSession::BlockKey> room_keys_;
+
     enum class RowType
     {
         NONE,
@@ -169,12 +211,21 @@ class MultiRoomIntegerProgramming : public CombMaker
     void GenLpFile(Vector<Vector<SolutionData>> &room_solutions, const Vector<double> &obj,
                    UInt32 row_cnt, UInt32 col_cnt, const Vector<double> &elems,
                    const Vector<int> &row_indices, Vector<int> &col_indices,
-                   const RowRangeMap& ranges, const Vector<double> &row_ub) const;
+                   const RowRangeMap& ranges, const Vector<double> &row_lb, const Vector<double> &row_ub,
+                   const Vector<double> &col_ub) const;
 
-    void GenCombForRooms(Vector<Vector<SolutionData>> &room_solutions, Vector<UInt32> &room_ranges, UInt32 &col_cnt);
+    void GenCombForRooms(Vector<Vector<SolutionData>> &room_solutions, Vector<UInt32> &room_ranges, UInt32 &col_cnt,
+                         SolveMetrics &metrics);
 
     [[nodiscard]] static UInt32 GetRoomIdx(UInt32 col, const Vector<UInt32> &room_ranges) ;
 
     [[nodiscard]] static UInt32 GetIndexInRoom(UInt32 col, const Vector<UInt32> &room_ranges) ;
+
+    void ApplyConstraints(const Vector<Vector<SolutionData>> &room_solutions,
+                          const Vector<UInt32> &op_inst_id_to_op_row_map,
+                          Vector<double> &col_ub, Vector<double> &row_lb) const;
+
+    void CollectRoomResults(const Vector<UInt32> &selected_cols, const Vector<Vector<SolutionData>> &room_solutions,
+                            const Vector<UInt32> &room_ranges, Vector<RoomResult> &out_rooms) const;
 };
 } // namespace albc::algorithm
\ No newline at end of file
@@ -1,7 +1,18 @@
 #pragma once
+#include "albc_types.h"
+
+#include <climits>
+#include <cstdint>
 
 namespace albc::algorithm
 {
 static constexpr double kDefaultModelTimeLimit = 3600 * 16;
 static constexpr double kDefaultSolveTimeLimit = 20;
+
+// 预计的组合及约束矩阵内存超过该值时，不建立整数规划，改用逐房间贪心求解
+static constexpr UInt64 kMaxIntegerProgrammingBytes = SIZE_MAX > UINT32_MAX ? 8ULL << 30 : 1ULL << 30;
+// Cbc以int为列下标
+static constexpr UInt64 kMaxIntegerProgrammingCols = INT_MAX;
+// 列数超过该值时，逐个移除干员重新求解的边际价值改用对偶价格估计
+static constexpr UInt64 kMaxLeaveOneOutCols = 500000;
 }
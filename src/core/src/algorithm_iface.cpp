@@ -6,9 +6,82 @@
 #include "data_player.h"
 #include "util_time.h"
 #include "algorithm_iface_params.h"
+#include "util_flat_hash_map.h"
 #include <future>
+#include <map>
+#include <random>
 namespace albc::algorithm::iface
 {
+namespace
+{
+// 以相同的键值对分别构造std::map与FlatHashMap，按打乱后的顺序查找全部键若干轮，输出平均每次查找的耗时
+template <typename TKey, typename TValue>
+void benchmark_lookup(const char *name, const Vector<std::pair<TKey, TValue>> &entries)
+{
+    constexpr int kRounds = 200;
+    if (entries.empty())
+        return;
+
+    const std::map<TKey, TValue> tree_map(entries.begin(), entries.end());
+    util::FlatHashMap<TKey, TValue> flat_map(entries.size());
+    for (const auto &entry : entries)
+        flat_map.insert(entry);
+
+    Vector<TKey> queries;
+    for (const auto &[key, value] : entries)
+        queries.push_back(key);
+    std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+    size_t tree_hits = 0;
+    const double tree_seconds = util::MeasureTime([&]() {
+        for (int r = 0; r < kRounds; ++r)
+            for (const auto &key : queries)
+                tree_hits += tree_map.find(key) != tree_map.end();
+    }).count();
+
+    size_t flat_hits = 0;
+    const double flat_seconds = util::MeasureTime([&]() {
+        for (int r = 0; r < kRounds; ++r)
+            for (const auto &key : queries)
+                flat_hits += flat_map.find(key) != flat_map.end();
+    }).count();
+
+    const double lookups = static_cast<double>(queries.size()) * kRounds;
+    LOG_I(name, ": ", entries.size(), " keys, std::map ", tree_seconds / lookups * 1e9, " ns/lookup, FlatHashMap ",
+          flat_seconds / lookups * 1e9, " ns/lookup, speedup ", tree_seconds / std::max(flat_seconds, 1e-12),
+          "x (hits: ", tree_hits, "/", flat_hits, ")");
+}
+
+// 使用实际数据中的键比较BuffMap、干员实例查找表及名称查找表改用FlatHashMap前后的查找耗时
+void benchmark_lookup_containers(const Json::Value &player_data_json, const Json::Value &game_data_json)
+{
+    const auto sc = SCOPE_TIMER_WITH_TRACE("Container lookup benchmark");
+    const data::building::BuildingData building_data(game_data_json);
+    const data::player::PlayerDataModel player_data(player_data_json);
+
+    Vector<std::pair<std::string, model::buff::RoomBuff *>> buff_entries;
+    for (const auto &[buff_id, buff] : *model::buff::BuffMap::instance())
+        buff_entries.emplace_back(buff_id, buff);
+    benchmark_lookup("BuffMap (buff id -> buff)", buff_entries);
+
+    Vector<std::pair<std::string, int>> char_to_inst_entries;
+    Vector<std::pair<int, std::string>> inst_to_char_entries;
+    for (const auto &[id, character] : player_data.troop.chars)
+    {
+        char_to_inst_entries.emplace_back(character->char_id, character->inst_id);
+        inst_to_char_entries.emplace_back(character->inst_id, character->char_id);
+    }
+    benchmark_lookup("Troop (char id -> inst id)", char_to_inst_entries);
+    benchmark_lookup("Troop (inst id -> char id)", inst_to_char_entries);
+
+    // 名称查找表依赖角色表，测试输入中没有角色表，以同为字符串到字符串的Buff名称查找代替
+    Vector<std::pair<std::string, std::string>> name_entries;
+    for (const auto &[buff_id, buff] : building_data.buffs)
+        name_entries.emplace_back(buff->buff_name, buff_id);
+    benchmark_lookup("Name (buff name -> buff id)", name_entries);
+}
+} // namespace
+
 void launch_test(const Json::Value &player_data_json, const Json::Value &game_data_json,
                  const AlbcTestConfig &test_config)
 {
@@ -26,6 +99,10 @@ void launch_test(const Json::Value &player_data_json, const Json::Value &game_da
         test_once(player_data_json, game_data_json, test_config);
         break;
 
+    case ALBC_TEST_MODE_RELOAD:
+        // 需要访问全局游戏数据存储，由API层的RunTest处理
+        throw std::invalid_argument("Reload test is not supported by the algorithm layer");
+
     default:
         ALBC_UNREACHABLE();
     }
@@ -66,7 +143,7 @@ void test_once(const Json::Value &player_data_json, const Json::Value &game_data
                 if (test_config.show_all_ops)
                 {
                     util::VariantPut(std::cout, "\"", buff->buff_id, "\": ", buff->buff_name, ": ",
-                               xml::strip_xml_tags(buff->description));
+                               buff->GetPlainDescription());
                 }
                 ++unsupported_buff_cnt;
             }
@@ -94,11 +171,24 @@ void test_once(const Json::Value &player_data_json, const Json::Value &game_data
     }
 
     GenTestModePlayerData(*player_data, *building_data);
-    AlgorithmParams params(*player_data, *building_data);
+    std::unique_ptr<AlgorithmParams> params_ptr;
+    const double params_seconds = util::MeasureTime([&]() {
+        params_ptr = std::make_unique<AlgorithmParams>(*player_data, *building_data);
+    }).count();
+    AlgorithmParams &params = *params_ptr;
+
+    // 干员与房间模型对象由内存池创建：不使用内存池时每个对象一次堆分配，使用后只有内存块的分配
+    const auto &arena_stats = params.GetArenaStats();
+    LOG_I("Model objects: ", arena_stats.allocations, " allocations, ", arena_stats.bytes, " bytes; arena: ",
+          arena_stats.blocks, " blocks, ", arena_stats.reserved, " bytes reserved; built in ", params_seconds * 1e3,
+          " ms.");
+    LOG_I("Heap allocations for model objects: ", arena_stats.allocations, " without arena -> ", arena_stats.blocks,
+          " with arena.");
+
     const auto sc = SCOPE_TIMER_WITH_TRACE("Solving");
     Vector<model::buff::RoomModel *> all_rooms;
-    const auto &manu_rooms = mem::unwrap_ptr_vector(params.GetRoomsOfType(data::building::RoomType::MANUFACTURE));
-    const auto &trade_rooms = mem::unwrap_ptr_vector(params.GetRoomsOfType(data::building::RoomType::TRADING));
+    const auto &manu_rooms = params.GetRoomsOfType(data::building::RoomType::MANUFACTURE);
+    const auto &trade_rooms = params.GetRoomsOfType(data::building::RoomType::TRADING);
 
     all_rooms.insert(all_rooms.end(), manu_rooms.begin(), manu_rooms.end());
     all_rooms.insert(all_rooms.end(), trade_rooms.begin(), trade_rooms.end());
@@ -142,6 +232,7 @@ void run_sequential_test(const Json::Value &player_data_json, const Json::Value
         test_once(player_data_json, game_data_json, test_config);
     }
 
+    benchmark_lookup_containers(player_data_json, game_data_json);
     LOG_I("Sequential test completed.");
 }
 } // namespace albc::algorithm::iface
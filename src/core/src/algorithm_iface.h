@@ -14,7 +14,8 @@ enum class TestMode
 {
     ONCE = 0,
     SEQUENTIAL = 1,
-    PARALLEL = 2
+    PARALLEL = 2,
+    RELOAD = 3
 };
 
 void launch_test(const Json::Value &player_data_json, const Json::Value &game_data_json,
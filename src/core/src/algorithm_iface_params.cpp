@@ -2,6 +2,7 @@
 // Created by Nonary on 2022/4/24.
 //
 #include "algorithm_iface_params.h"
+#include "util_flat_hash_map.h"
 #include <unordered_set>
 
 namespace albc::algorithm::iface
@@ -102,11 +103,10 @@ model::buff::GlobalAttributeFields GlobalAttributeFactory(const CustomPackedInpu
     return attr;
 }
 
-std::unique_ptr<model::buff::RoomModel> RoomFactory(const std::string &id,
-                                                    const data::player::PlayerBuildingManufacture &manufacture_room,
-                                                    int level)
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const std::string &id,
+                                    const data::player::PlayerBuildingManufacture &manufacture_room, int level)
 {
-    auto room = std::make_unique<model::buff::RoomModel>();
+    auto room = arena.New<model::buff::RoomModel>();
     room->type = data::building::RoomType::MANUFACTURE;
     room->id = id;
     room->max_slot_count = level;
@@ -138,10 +138,10 @@ std::unique_ptr<model::buff::RoomModel> RoomFactory(const std::string &id,
 
     return room;
 }
-std::unique_ptr<model::buff::RoomModel> RoomFactory(const std::string &id,
-                                                    const data::player::PlayerBuildingTrading &trading_room, int level)
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const std::string &id,
+                                    const data::player::PlayerBuildingTrading &trading_room, int level)
 {
-    auto room = std::make_unique<model::buff::RoomModel>();
+    auto room = arena.New<model::buff::RoomModel>();
     room->type = data::building::RoomType::TRADING;
     room->id = id;
     room->max_slot_count = level;
@@ -153,9 +153,9 @@ std::unique_ptr<model::buff::RoomModel> RoomFactory(const std::string &id,
 
     return room;
 }
-std::unique_ptr<model::buff::RoomModel> RoomFactory(const CustomRoomData &room_data)
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const CustomRoomData &room_data)
 {
-    auto room = std::make_unique<model::buff::RoomModel>();
+    auto room = arena.New<model::buff::RoomModel>();
     room->type = room_data.type;
     room->id = room_data.identifier;
     room->max_slot_count = room_data.max_slot_cnt;
@@ -218,13 +218,13 @@ AlgorithmParams::AlgorithmParams(const data::player::PlayerDataModel &player_dat
             continue;
         }
 
-        const auto op = new model::OperatorModel(*player_char, *player_data.building.chars.at(inst_id));
+        const auto op = arena_.New<model::OperatorModel>(*player_char, *player_data.building.chars.at(inst_id), &arena_);
         op->identifier = player_char->char_id;
         op->Empower(lookup, *player_char, building_data);
-        operators_.emplace_back(op);
+        operators_.push_back(op);
     }
 
-    Dictionary<std::string, int> room_level_map;
+    util::FlatHashMap<std::string, int> room_level_map(player_data.building.room_slots.size());
     model::buff::GlobalAttributeFields global_attr = GlobalAttributeFactory(player_data.building);
 
     for (const auto &[id, slot] : player_data.building.room_slots)
@@ -234,16 +234,16 @@ AlgorithmParams::AlgorithmParams(const data::player::PlayerDataModel &player_dat
 
     for (const auto &[id, manu_room] : player_data.building.player_building_room.manufacture)
     {
-        auto room = RoomFactory(id, manu_room, room_level_map[id]);
+        auto room = RoomFactory(arena_, id, manu_room, room_level_map[id]);
         room->global_attributes = global_attr;
-        AddRoom(data::building::RoomType::MANUFACTURE, std::move(room));
+        AddRoom(data::building::RoomType::MANUFACTURE, room);
     }
 
     for (const auto &[id, trade_room] : player_data.building.player_building_room.trading)
     {
-        auto room = RoomFactory(id, trade_room, room_level_map[id]);
+        auto room = RoomFactory(arena_, id, trade_room, room_level_map[id]);
         room->global_attributes = global_attr;
-        AddRoom(data::building::RoomType::TRADING, std::move(room));
+        AddRoom(data::building::RoomType::TRADING, room);
     }
 }
 AlgorithmParams::AlgorithmParams(const CustomPackedInput &custom_input,
@@ -261,11 +261,11 @@ AlgorithmParams::AlgorithmParams(const CustomPackedInput &custom_input,
             else
                 char_ids.emplace_back(inst_id_counter, "CUSTOM_CHAR_" + std::to_string(inst_id_counter));
 
-            auto op = std::make_unique<model::OperatorModel>(inst_id_counter, custom_char.resolved_char_id,
-                                                             static_cast<UInt32>(3600. * custom_char.morale));
+            auto op = arena_.New<model::OperatorModel>(inst_id_counter, custom_char.resolved_char_id,
+                                                       static_cast<UInt32>(3600. * custom_char.morale), &arena_);
             op->identifier = custom_char.identifier;
-            op->sp_char_group = custom_char.sp_char_group;
-            operators_.emplace_back(std::move(op));
+            op->SetSpCharGroup(custom_char.sp_char_group);
+            operators_.push_back(op);
         }
     }
 
@@ -303,9 +303,9 @@ AlgorithmParams::AlgorithmParams(const CustomPackedInput &custom_input,
     const auto global_attr = GlobalAttributeFactory(custom_input);
     for (const auto &custom_room : custom_input.rooms)
     {
-        auto room = RoomFactory(custom_room);
+        auto room = RoomFactory(arena_, custom_room);
         room->global_attributes = global_attr;
-        AddRoom(custom_room.type, std::move(room));
+        AddRoom(custom_room.type, room);
     }
 }
 void AlgorithmParams::UpdateGlobalAttributes(const model::buff::GlobalAttributeFields &global_attr) const
@@ -314,7 +314,7 @@ void AlgorithmParams::UpdateGlobalAttributes(const model::buff::GlobalAttributeF
         for (const auto &room : rooms)
             room->global_attributes = global_attr;
 }
-const mem::PtrVector<model::buff::RoomModel> &AlgorithmParams::GetRoomsOfType(data::building::RoomType type) const
+const Vector<model::buff::RoomModel *> &AlgorithmParams::GetRoomsOfType(data::building::RoomType type) const
 {
     if (UInt32 type_val = static_cast<UInt32>(type), idx = util::ctz(type_val);
         util::is_pow_of_two(type_val) && idx > 0 && idx < static_cast<UInt32>(rooms_map_.size()))
@@ -331,8 +331,8 @@ int AlgorithmParams::GetRoomTypeIndex(const data::building::RoomType type)
 {
     return util::ctz(static_cast<UInt32>(type));
 }
-void AlgorithmParams::AddRoom(const data::building::RoomType type, std::unique_ptr<model::buff::RoomModel> &&room)
+void AlgorithmParams::AddRoom(const data::building::RoomType type, model::buff::RoomModel *room)
 {
-    rooms_map_[GetRoomTypeIndex(type)].emplace_back(std::move(room));
+    rooms_map_[GetRoomTypeIndex(type)].push_back(room);
 }
 }
@@ -3,33 +3,40 @@
 //
 #pragma once
 #include "algorithm_iface_custom.h"
+#include "algorithm_params.h"
 #include "data_building.h"
 #include "data_player.h"
 #include "data_player_building.h"
 #include "model_buff_primitives.h"
 #include "model_operator.h"
+#include "util_arena.h"
 
 #include <bitset>
 
 namespace albc::algorithm::iface
 {
 
-using PlayerBuildingRoomMap = Array<mem::PtrVector<model::buff::RoomModel>, data::building::kRoomTypeCount>;
+using PlayerBuildingRoomMap = Array<Vector<model::buff::RoomModel *>, data::building::kRoomTypeCount>;
 
 model::buff::GlobalAttributeFields GlobalAttributeFactory(const data::player::PlayerBuilding &building);
 
-std::unique_ptr<model::buff::RoomModel> RoomFactory(
-    const std::string &id, const data::player::PlayerBuildingManufacture &manufacture_room, int level);
+// 房间在arena中创建，由arena持有
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const std::string &id,
+                                    const data::player::PlayerBuildingManufacture &manufacture_room, int level);
 
-std::unique_ptr<model::buff::RoomModel> RoomFactory(const std::string &id,
-                                                           const data::player::PlayerBuildingTrading &trading_room,
-                                                           int level);
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const std::string &id,
+                                    const data::player::PlayerBuildingTrading &trading_room, int level);
 
-std::unique_ptr<model::buff::RoomModel> RoomFactory(const CustomRoomData &room_data);
+model::buff::RoomModel *RoomFactory(mem::MonotonicArena &arena, const CustomRoomData &room_data);
 
 [[maybe_unused]] void GenTestModePlayerData(data::player::PlayerDataModel &player_data,
                                                    const data::building::BuildingData &building_data);
 
+/**
+ * @brief 一次求解的输入模型
+ *
+ * 干员、干员的Buff及房间都在内部的单调内存池中创建，与AlgorithmParams同时一次性释放。
+ */
 class AlgorithmParams
 {
   public:
@@ -39,19 +46,48 @@ class AlgorithmParams
 
     [[maybe_unused]] void UpdateGlobalAttributes(const model::buff::GlobalAttributeFields &global_attr) const;
 
-    [[nodiscard]] const mem::PtrVector<model::buff::RoomModel> &GetRoomsOfType(data::building::RoomType type) const;
+    [[nodiscard]] const Vector<model::buff::RoomModel *> &GetRoomsOfType(data::building::RoomType type) const;
 
-    [[nodiscard]] const mem::PtrVector<model::OperatorModel> &GetOperators() const
+    [[nodiscard]] const Vector<model::OperatorModel *> &GetOperators() const
     {
         return operators_;
     }
 
+    [[nodiscard]] const mem::MonotonicArena::Stats &GetArenaStats() const
+    {
+        return arena_.GetStats();
+    }
+
+    void SetConstraints(OperatorConstraints constraints)
+    {
+        constraints_ = std::move(constraints);
+    }
+
+    [[nodiscard]] const OperatorConstraints &GetConstraints() const
+    {
+        return constraints_;
+    }
+
+    void SetCancellationToken(std::shared_ptr<const CancellationToken> token)
+    {
+        cancel_token_ = std::move(token);
+    }
+
+    // 未设置时返回空指针
+    [[nodiscard]] const CancellationToken *GetCancellationToken() const
+    {
+        return cancel_token_.get();
+    }
+
   private:
+    mem::MonotonicArena arena_; // 必须先于其中的对象被引用的成员声明
     PlayerBuildingRoomMap rooms_map_;
-    mem::PtrVector<model::OperatorModel> operators_;
+    Vector<model::OperatorModel *> operators_;
+    OperatorConstraints constraints_;
+    std::shared_ptr<const CancellationToken> cancel_token_;
 
     [[nodiscard]] static int GetRoomTypeIndex(data::building::RoomType type);
 
-    void AddRoom(data::building::RoomType type, std::unique_ptr<model::buff::RoomModel> &&room);
+    void AddRoom(data::building::RoomType type, model::buff::RoomModel *room);
 };
 } // namespace albc::algorithm::iface
\ No newline at end of file
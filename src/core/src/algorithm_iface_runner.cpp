@@ -5,23 +5,105 @@
 
 namespace albc::algorithm::iface
 {
+static Vector<model::buff::RoomModel *> GetAllRooms(const AlgorithmParams &params)
+{
+    Vector<model::buff::RoomModel *> all_rooms;
+    const auto &manu_rooms = params.GetRoomsOfType(data::building::RoomType::MANUFACTURE);
+    const auto &trade_rooms = params.GetRoomsOfType(data::building::RoomType::TRADING);
+    all_rooms.insert(all_rooms.end(), manu_rooms.begin(), manu_rooms.end());
+    all_rooms.insert(all_rooms.end(), trade_rooms.begin(), trade_rooms.end());
+    return all_rooms;
+}
+SolveStrategy SelectSolveStrategy(const CombEstimate &estimate, const AlbcSolverParameters &solver_params)
+{
+    SolveStrategy strategy;
+    strategy.greedy = estimate.col_cnt > kMaxIntegerProgrammingCols || estimate.MemoryBytes() > kMaxIntegerProgrammingBytes;
+    strategy.marginal_value_mode = solver_params.marginal_value_mode;
+    if (strategy.greedy)
+    {
+        // 贪心求解没有整数规划模型，无法计算边际价值
+        strategy.marginal_value_mode = ALBC_MARGINAL_VALUE_NONE;
+    }
+    else if (strategy.marginal_value_mode == ALBC_MARGINAL_VALUE_LEAVE_ONE_OUT && estimate.col_cnt > kMaxLeaveOneOutCols)
+    {
+        strategy.marginal_value_mode = ALBC_MARGINAL_VALUE_DUAL;
+    }
+    return strategy;
+}
+void EstimateComb(const AlgorithmParams &params, CombEstimate &out_estimate)
+{
+    MultiRoomIntegerProgramming estimator(GetAllRooms(params), params.GetOperators(), AlbcSolverParameters{});
+    estimator.Estimate(out_estimate);
+}
 
 void MultiRoomIntegerProgramRunner::Run(const AlgorithmParams &params, const AlbcSolverParameters &solver_params,
                                         AlgorithmResult &out_result) const
+{
+    RunImpl(params, solver_params, nullptr, out_result);
+}
+void MultiRoomIntegerProgramRunner::Run(const AlgorithmParams &params, const AlbcSolverParameters &solver_params,
+                                        SolveSession &session, AlgorithmResult &out_result) const
+{
+    RunImpl(params, solver_params, &session, out_result);
+}
+void MultiRoomIntegerProgramRunner::RunImpl(const AlgorithmParams &params, const AlbcSolverParameters &solver_params,
+                                            SolveSession *session, AlgorithmResult &out_result)
 {
     using namespace algorithm;
-    Vector<model::buff::RoomModel *> all_rooms;
-    const auto &manu_rooms = mem::unwrap_ptr_vector(params.GetRoomsOfType(data::building::RoomType::MANUFACTURE));
-    const auto &trade_rooms = mem::unwrap_ptr_vector(params.GetRoomsOfType(data::building::RoomType::TRADING));
-    all_rooms.insert(all_rooms.end(), manu_rooms.begin(), manu_rooms.end());
-    all_rooms.insert(all_rooms.end(), trade_rooms.begin(), trade_rooms.end());
+    const auto all_rooms = GetAllRooms(params);
 
     AlbcSolverParameters actual_solver_params = solver_params;
     if (actual_solver_params.model_time_limit <= 0) actual_solver_params.model_time_limit = kDefaultModelTimeLimit;
     if (actual_solver_params.solve_time_limit <= 0) actual_solver_params.solve_time_limit = kDefaultSolveTimeLimit;
 
+    // 估计与整数规划共用同一次筛选，选择贪心时该对象只用于估计
     MultiRoomIntegerProgramming alg_all(all_rooms, params.GetOperators(), actual_solver_params);
-    alg_all.Run(out_result);
+    CombEstimate estimate;
+    alg_all.Estimate(estimate);
+    const auto strategy = SelectSolveStrategy(estimate, actual_solver_params);
+    if (strategy.marginal_value_mode != actual_solver_params.marginal_value_mode)
+    {
+        LOG_I("Marginal value mode changed to ", util::enum_to_string(strategy.marginal_value_mode), " for ",
+              estimate.col_cnt, " estimated columns");
+        actual_solver_params.marginal_value_mode = strategy.marginal_value_mode;
+    }
+
+    if (strategy.greedy)
+    {
+        const auto &constraints = params.GetConstraints();
+        if (!constraints.pinned_ops.empty())
+            throw std::runtime_error("Model is too large to solve with pinned characters: " +
+                                     std::to_string(estimate.col_cnt) + " estimated columns");
+
+        LOG_W("Estimated ", estimate.col_cnt, " columns and ", estimate.MemoryBytes(),
+              " bytes exceed the integer programming limit, falling back to greedy solving");
+        Vector<model::OperatorModel *> ops;
+        std::copy_if(params.GetOperators().begin(), params.GetOperators().end(), std::back_inserter(ops),
+                     [&constraints](const model::OperatorModel *op) {
+                         return !constraints.forbidden_ops.count(op->identifier);
+                     });
+
+        MultiRoomGreedy alg_greedy(all_rooms, ops, actual_solver_params);
+        alg_greedy.SetCancellationToken(params.GetCancellationToken());
+        alg_greedy.Run(out_result);
+    }
+    else
+    {
+        alg_all.SetSolverParameters(actual_solver_params);
+        alg_all.SetSession(session);
+        alg_all.SetConstraints(&params.GetConstraints());
+        alg_all.SetCancellationToken(params.GetCancellationToken());
+        alg_all.Run(out_result);
+    }
+
+    out_result.metrics.estimated_col_cnt = estimate.col_cnt;
+    out_result.metrics.estimated_memory_bytes = estimate.MemoryBytes();
+    out_result.metrics.greedy = strategy.greedy;
+
+    const auto &arena_stats = params.GetArenaStats();
+    out_result.metrics.arena_allocations = arena_stats.allocations;
+    out_result.metrics.arena_blocks = arena_stats.blocks;
+    out_result.metrics.arena_bytes = arena_stats.reserved;
 }
 void TestRunner::Run(const AlgorithmParams &params, const AlbcSolverParameters &solver_params,
                      AlgorithmResult &out_result) const
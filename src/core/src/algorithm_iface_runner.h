@@ -7,10 +7,29 @@
 
 namespace albc::algorithm::iface
 {
+// 根据组合数估计选择的求解策略
+struct SolveStrategy
+{
+    bool greedy = false; // 逐房间选取最优组合，不保存全部组合也不建立整数规划
+    AlbcMarginalValueMode marginal_value_mode = ALBC_MARGINAL_VALUE_NONE;
+};
+
+[[nodiscard]] SolveStrategy SelectSolveStrategy(const CombEstimate &estimate, const AlbcSolverParameters &solver_params);
+
+// 只筛选干员并划分互斥组，估计各房间的组合数及内存占用，不求解。供只估计的调用使用，求解时Run自行估计
+void EstimateComb(const AlgorithmParams &params, CombEstimate &out_estimate);
+
 class IRunner
 {
 public:
     virtual void Run(const AlgorithmParams & params, const AlbcSolverParameters& solver_params, AlgorithmResult & out_result) const = 0;
+
+    // 在求解会话中运行，默认实现忽略会话
+    virtual void Run(const AlgorithmParams & params, const AlbcSolverParameters& solver_params, SolveSession & session, AlgorithmResult & out_result) const
+    {
+        (void)session;
+        Run(params, solver_params, out_result);
+    }
 };
 
 class MultiRoomIntegerProgramRunner : public IRunner
@@ -18,6 +37,10 @@ class MultiRoomIntegerProgramRunner : public IRunner
 public:
     MultiRoomIntegerProgramRunner() = default;
     void Run(const AlgorithmParams & params, const AlbcSolverParameters& solver_params, AlgorithmResult & out_result) const override;
+    void Run(const AlgorithmParams & params, const AlbcSolverParameters& solver_params, SolveSession & session, AlgorithmResult & out_result) const override;
+
+private:
+    static void RunImpl(const AlgorithmParams & params, const AlbcSolverParameters& solver_params, SolveSession * session, AlgorithmResult & out_result);
 };
 
 class TestRunner : public IRunner
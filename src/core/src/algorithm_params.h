@@ -2,22 +2,138 @@
 #include "albc_types.h"
 #include "algorithm_primitives.h"
 
+#include <atomic>
+#include <stdexcept>
+
 namespace albc::algorithm
 {
 
+// 求解被取消时抛出
+class OperationCancelledError : public std::runtime_error
+{
+  public:
+    OperationCancelledError() : std::runtime_error("operation cancelled") {}
+};
+
+// 协作式取消标志。请求方调用Cancel，算法在组合枚举和Cbc求解中定期检查并尽快退出
+class CancellationToken
+{
+  public:
+    void Cancel() noexcept
+    {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool IsCancelled() const noexcept
+    {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+    void ThrowIfCancelled() const
+    {
+        if (IsCancelled())
+            throw OperationCancelledError();
+    }
+
+  private:
+    std::atomic<bool> cancelled_{false};
+};
+
+// 干员约束，在已生成的组合上以列上界/行下界的形式施加，不需要重新生成组合
+struct OperatorConstraints
+{
+    Set<std::string> forbidden_ops;                  // 不参与排班的干员标识符
+    Dictionary<std::string, std::string> pinned_ops; // 干员标识符 -> 该干员必须所在的房间标识符
+
+    [[nodiscard]] bool Empty() const
+    {
+        return forbidden_ops.empty() && pinned_ops.empty();
+    }
+};
+
 struct RoomResult
 {
     SolutionData solution;
     model::buff::RoomModel* room = nullptr;
 };
 
+// 单个房间组合数（列数）的估计，只筛选干员并划分互斥组，不枚举组合
+struct RoomCombEstimate
+{
+    UInt32 inbound_ops = 0;      // 可进入该房间的干员数
+    UInt32 comb_size = 0;        // 每个组合的干员数
+    UInt32 mutex_groups = 0;     // 互斥组数
+    UInt64 base_comb_cnt = 0;    // 非互斥干员的组合数 C(n, k)
+    UInt64 mutex_comb_cnt = 0;   // 互斥组的取法数，即各组大小之积
+    UInt64 partial_comb_cnt = 0; // 每种互斥取法新增的组合数
+    UInt64 col_cnt = 0;          // base_comb_cnt + mutex_comb_cnt * partial_comb_cnt
+    UInt64 solution_bytes = 0;   // 保存全部组合所需的内存
+    UInt64 matrix_bytes = 0;     // 整数规划约束矩阵中属于这些列的部分
+};
+
+// 所有房间的估计，数值溢出时饱和为UINT64_MAX
+struct CombEstimate
+{
+    UInt64 col_cnt = 0;
+    UInt64 solution_bytes = 0;
+    UInt64 matrix_bytes = 0;
+    Dictionary<std::string, RoomCombEstimate> rooms; // 房间标识符 -> 估计
+
+    [[nodiscard]] UInt64 MemoryBytes() const
+    {
+        return util::saturating_add(solution_bytes, matrix_bytes);
+    }
+};
+
+// 单个房间的组合生成统计
+struct RoomSolveMetrics
+{
+    double filter_seconds = 0; // 筛选可进入该房间的干员
+    double comb_seconds = 0;   // 枚举组合，命中会话缓存时为0
+    UInt32 inbound_ops = 0;    // 可进入该房间的干员数
+    UInt64 calc_cnt = 0;       // 枚举过的组合数
+    UInt32 col_cnt = 0;        // 生成的列数
+    bool cached = false;       // 组合是否取自会话缓存
+};
+
+// 一次求解各阶段的耗时（秒）与模型规模
+struct SolveMetrics
+{
+    double resolve_seconds = 0;         // 由输入解析干员、房间数据
+    double params_seconds = 0;          // 构造AlgorithmParams
+    double comb_seconds = 0;            // 所有房间的干员筛选与组合生成
+    double matrix_seconds = 0;          // 建立整数规划的约束矩阵
+    double cbc_seconds = 0;             // Cbc求解最优方案
+    double alternatives_seconds = 0;    // 求解备选方案
+    double marginal_values_seconds = 0; // 计算干员边际价值
+    UInt64 calc_cnt = 0;                // 所有房间枚举过的组合数
+    UInt32 col_cnt = 0;
+    UInt32 row_cnt = 0;
+    UInt32 nonzero_cnt = 0;
+    Int64 nodes = 0;                    // Cbc搜索的分支节点数
+    double gap = 0;                     // 最优方案的相对间隙，已证明最优时为0
+    UInt64 arena_allocations = 0;       // 在AlgorithmParams内存池中创建的对象数，即原本需要的堆分配次数
+    UInt64 arena_blocks = 0;            // 内存池实际进行的堆分配次数
+    UInt64 arena_bytes = 0;             // 内存池占用的字节数
+    UInt64 estimated_col_cnt = 0;       // 求解前估计的列数
+    UInt64 estimated_memory_bytes = 0;  // 求解前估计的组合及约束矩阵内存
+    bool greedy = false;                // 估计的内存超出限制，改用逐房间贪心求解
+    Dictionary<std::string, RoomSolveMetrics> rooms; // 房间标识符 -> 统计
+};
+
 struct AlgorithmResult
 {
     Vector<RoomResult> rooms;
+    Vector<Vector<RoomResult>> alternatives; // 备选方案，按总产能降序排列，不含最优方案
+    Dictionary<std::string, double> marginal_values; // 干员标识符 -> 边际价值（移除该干员后总产能的减少量）
+    SolveMetrics metrics;
 
     void Clear()
     {
         rooms.clear();
+        alternatives.clear();
+        marginal_values.clear();
+        metrics = {};
     }
 };
 
@@ -30,9 +30,9 @@ class SolutionData
 struct GreedySolutionHolder
 {
     SolutionData max_solution;
-    UInt32 calc_cnt = 0;
+    UInt64 calc_cnt = 0;
 
-    void Reserve(size_t)
+    void Reserve(UInt64)
     {
         // do nothing
     }
@@ -58,21 +58,25 @@ struct GreedySolutionHolder
         }
     }
 
-    void UpdateCalcCnt(UInt32 cnt)
+    // 每次MakePartialComb结束时累加
+    void AddCalcCnt(UInt64 cnt)
     {
-        this->calc_cnt = cnt;
+        this->calc_cnt += cnt;
     }
 };
 
 struct AllSolutionHolder
 {
     Vector<SolutionData> solutions;
-    UInt32 calc_cnt = 0;
+    UInt64 calc_cnt = 0;
     size_t sol_cnt = 0;
 
-    void Reserve(size_t size)
+    void Reserve(UInt64 size)
     {
-        Vector<SolutionData> tmp(size);
+        if (size > SIZE_MAX / sizeof(SolutionData))
+            throw std::length_error("Too many combinations: " + std::to_string(size));
+
+        Vector<SolutionData> tmp(static_cast<size_t>(size));
         solutions.swap(tmp);
         sol_cnt = 0;
     }
@@ -96,9 +100,10 @@ struct AllSolutionHolder
         }
     }
 
-    void UpdateCalcCnt(UInt32 cnt)
+    // 每次MakePartialComb结束时累加
+    void AddCalcCnt(UInt64 cnt)
     {
-        this->calc_cnt = cnt;
+        this->calc_cnt += cnt;
     }
 };
 
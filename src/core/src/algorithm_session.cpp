@@ -0,0 +1,192 @@
+#include "algorithm_session.h"
+#include "util.h"
+#include "util_log.h"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace albc::algorithm
+{
+SolveSession::BlockSignature SolveSession::MakeBlockSignature(const model::buff::RoomModel &room,
+                                                              const Vector<model::OperatorModel *> &inbound_ops,
+                                                              const Vector<model::OperatorModel *> &all_ops,
+                                                              double model_time_limit)
+{
+    BlockSignature sig;
+    auto put = [&sig](const auto &value) {
+        static_assert(std::is_trivially_copyable_v<std::decay_t<decltype(value)>>);
+        sig.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    };
+
+    put(room.id.size());
+    sig.append(room.id);
+    put(room.type);
+    put(room.max_slot_count);
+    put(room.room_attributes.prod_type);
+    put(room.room_attributes.order_type);
+    put(room.room_attributes.base_prod_eff);
+    put(room.room_attributes.base_prod_cap);
+    put(room.room_attributes.base_char_cost);
+    put(room.room_attributes.prod_cnt);
+    for (const auto attr : room.global_attributes)
+        put(attr);
+    put(model_time_limit);
+
+    put(inbound_ops.size());
+    for (const auto *op : inbound_ops)
+    {
+        put(op->inst_id);
+        put(op->char_key);
+        put(op->duration);
+        put(op->buffs.size());
+        for (const auto *buff : op->buffs)
+            put(buff->GetBuffKey());
+    }
+
+    // 部分Buff的效果依赖于其他干员是否存在（UpdateLookup），因此全体干员也需要参与计算
+    put(all_ops.size());
+    for (const auto *op : all_ops)
+    {
+        put(op->inst_id);
+        put(op->char_key);
+    }
+    return sig;
+}
+
+SolveSession::BlockKey SolveSession::MakeBlockKey(const BlockSignature &signature)
+{
+    return std::hash<BlockSignature>{}(signature);
+}
+
+void SolveSession::BeginSolve()
+{
+    for (auto &[key, block] : blocks_)
+        block.used = false;
+}
+
+void SolveSession::EndSolve(const Vector<BlockKey> &room_keys, const Vector<UInt32> &room_ranges,
+                            const Vector<UInt32> &selected_cols)
+{
+    for (auto it = blocks_.begin(); it != blocks_.end();)
+    {
+        if (it->second.used)
+            ++it;
+        else
+            it = blocks_.erase(it);
+    }
+
+    last_selected_.clear();
+    for (const UInt32 c : selected_cols)
+    {
+        auto room_it = std::upper_bound(room_ranges.begin(), room_ranges.end(), c);
+        if (room_it == room_ranges.begin())
+            continue;
+
+        const auto room_idx = static_cast<size_t>(room_it - room_ranges.begin() - 1);
+        last_selected_.emplace_back(room_keys[room_idx], c - room_ranges[room_idx]);
+    }
+    LOG_D("Solve session: ", blocks_.size(), " column blocks cached, ", last_selected_.size(), " columns selected.");
+}
+
+bool SolveSession::TryGetColumns(BlockKey key, const BlockSignature &signature,
+                                 const Vector<model::OperatorModel *> &inbound_ops,
+                                 Vector<SolutionData> &out_solutions)
+{
+    const auto it = blocks_.find(key);
+    if (it == blocks_.end())
+        return false;
+
+    auto &block = it->second;
+    if (block.signature != signature)
+    {
+        LOG_D("Solve session: column block key collision, regenerating combinations.");
+        return false;
+    }
+
+    Vector<SolutionData> solutions = block.solutions;
+    for (size_t i = 0; i < solutions.size(); ++i)
+    {
+        for (size_t j = 0; j < model::buff::kRoomMaxOperators; ++j)
+        {
+            const auto op_idx = block.op_indices[i][j];
+            if (op_idx == kNoOperator)
+            {
+                solutions[i].operators[j] = nullptr;
+            }
+            else if (op_idx < inbound_ops.size())
+            {
+                solutions[i].operators[j] = inbound_ops[op_idx];
+            }
+            else
+            {
+                LOG_W("Solve session: cached operator index ", op_idx, " out of range (", inbound_ops.size(),
+                      "), regenerating combinations.");
+                return false;
+            }
+        }
+    }
+    out_solutions = std::move(solutions);
+    block.used = true;
+    return true;
+}
+
+void SolveSession::StoreColumns(BlockKey key, const BlockSignature &signature,
+                                const Vector<model::OperatorModel *> &inbound_ops,
+                                const Vector<SolutionData> &solutions)
+{
+    last_selected_.erase(std::remove_if(last_selected_.begin(), last_selected_.end(),
+                                        [key](const auto &sel) { return sel.first == key; }),
+                         last_selected_.end());
+
+    auto &block = blocks_[key];
+    block.signature = signature;
+    block.solutions = solutions;
+    block.op_indices.resize(solutions.size());
+    block.used = true;
+    for (size_t i = 0; i < solutions.size(); ++i)
+    {
+        for (size_t j = 0; j < model::buff::kRoomMaxOperators; ++j)
+        {
+            auto *&op = block.solutions[i].operators[j];
+            const auto op_it = std::find(inbound_ops.begin(), inbound_ops.end(), op);
+            block.op_indices[i][j] =
+                op && op_it != inbound_ops.end() ? static_cast<UInt32>(op_it - inbound_ops.begin()) : kNoOperator;
+            op = nullptr;
+        }
+    }
+}
+
+Vector<UInt32> SolveSession::GetWarmStartCols(const Vector<BlockKey> &room_keys,
+                                              const Vector<UInt32> &room_ranges) const
+{
+    Vector<UInt32> cols;
+    for (const auto &[key, idx_in_block] : last_selected_)
+    {
+        const auto room_it = std::find(room_keys.begin(), room_keys.end(), key);
+        if (room_it == room_keys.end())
+            continue;
+
+        cols.push_back(room_ranges[room_it - room_keys.begin()] + idx_in_block);
+    }
+    return cols;
+}
+
+size_t SolveSession::GetBlockCount() const
+{
+    return blocks_.size();
+}
+
+size_t SolveSession::GetColumnCount() const
+{
+    size_t cnt = 0;
+    for (const auto &[key, block] : blocks_)
+        cnt += block.solutions.size();
+    return cnt;
+}
+
+void SolveSession::Clear()
+{
+    blocks_.clear();
+    last_selected_.clear();
+}
+} // namespace albc::algorithm
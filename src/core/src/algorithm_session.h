@@ -0,0 +1,69 @@
+#pragma once
+#include "albc_types.h"
+#include "algorithm_primitives.h"
+
+#include <string>
+#include <unordered_map>
+
+namespace albc::algorithm
+{
+/**
+ * @brief 求解会话，在多次求解之间缓存各房间生成的组合（列块）以及上一次选中的列
+ *
+ * 列块以房间签名及其可用干员集合为键。两次求解之间房间属性和可用干员均未变化的房间直接复用缓存的组合，
+ * 只有发生变化的房间会重新枚举。上一次选中的列中仍然有效的部分会作为初始解传给Cbc。
+ */
+class SolveSession
+{
+  public:
+    using BlockKey = size_t;
+    using BlockSignature = std::string;
+
+    // 将房间属性、房间可用干员及全体干员（Buff查找表依赖全体干员）编码为列块的签名
+    [[nodiscard]] static BlockSignature MakeBlockSignature(const model::buff::RoomModel &room,
+                                                           const Vector<model::OperatorModel *> &inbound_ops,
+                                                           const Vector<model::OperatorModel *> &all_ops,
+                                                           double model_time_limit);
+
+    [[nodiscard]] static BlockKey MakeBlockKey(const BlockSignature &signature);
+
+    // 开始一次求解，将所有列块标记为未使用
+    void BeginSolve();
+
+    // 结束一次求解，移除本次未使用的列块，并记录本次选中的列
+    void EndSolve(const Vector<BlockKey> &room_keys, const Vector<UInt32> &room_ranges,
+                  const Vector<UInt32> &selected_cols);
+
+    // 取出缓存的组合，并将组合中的干员指针重新映射到本次的inbound_ops上。
+    // 签名不一致（键冲突）或干员下标越界时返回false，由调用方重新生成组合
+    bool TryGetColumns(BlockKey key, const BlockSignature &signature,
+                       const Vector<model::OperatorModel *> &inbound_ops, Vector<SolutionData> &out_solutions);
+
+    // 存入组合，覆盖同键的旧列块，旧列块上一次选中的列不再用作初始解
+    void StoreColumns(BlockKey key, const BlockSignature &signature,
+                      const Vector<model::OperatorModel *> &inbound_ops, const Vector<SolutionData> &solutions);
+
+    // 上一次选中的列在本次求解中对应的列号，所在房间的列块未被复用的列会被忽略
+    [[nodiscard]] Vector<UInt32> GetWarmStartCols(const Vector<BlockKey> &room_keys,
+                                                  const Vector<UInt32> &room_ranges) const;
+
+    [[nodiscard]] size_t GetBlockCount() const;
+    [[nodiscard]] size_t GetColumnCount() const;
+
+    void Clear();
+
+  private:
+    struct ColumnBlock
+    {
+        BlockSignature signature; // 用于在命中时排除哈希冲突
+        Vector<SolutionData> solutions; // 干员指针已清空，取出时根据op_indices重新填充
+        Vector<Array<UInt32, model::buff::kRoomMaxOperators>> op_indices; // 组合中各干员在inbound_ops中的下标
+        bool used = false;
+    };
+
+    static constexpr UInt32 kNoOperator = UINT32_MAX;
+
+    std::unordered_map<BlockKey, ColumnBlock> blocks_;
+    Vector<std::pair<BlockKey, UInt32 /* index in block */>> last_selected_;
+};
+} // namespace albc::algorithm
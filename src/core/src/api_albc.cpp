@@ -11,8 +11,23 @@
 #include "data_character_table.h"
 #include "api_json_params.h"
 #include "api_di.h"
+#include "api_result_cache.h"
+#include "api_storage.h"
+#include "util_json_snapshot.h"
+#include "api_game_data_snapshot.h"
+#include "api_statistics.h"
+#include "util_string_interner.h"
+#include "util_thread_pool.h"
 
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <future>
 #include <memory>
+#include <ostream>
+#include <sstream>
+#include <string_view>
+#include <thread>
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
@@ -209,7 +224,7 @@ void LoadGameDataJson(AlbcGameDataDbType data_type, const char *json, AlbcExcept
 {
     try
     {
-        api::GetGlobalGameDataStorage().Store(data_type, util::read_json_from_char_array(json));
+        api::LoadGameData(data_type, util::read_json_from_char_array(json));
     }
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
 }
@@ -217,15 +232,120 @@ void LoadGameDataFile(AlbcGameDataDbType data_type, const char *path, AlbcExcept
 {
     try
     {
-        api::GetGlobalGameDataStorage().Store(data_type, util::read_json_from_file(path));
+        api::LoadGameData(data_type, util::read_json_or_snapshot_from_file(path));
     }
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
 }
+void CompileGameDataSnapshot(const char *json_path, const char *snapshot_path, AlbcException **e_ptr)
+{
+    try
+    {
+        const auto snapshot = util::compile_json_snapshot(util::read_json_or_snapshot_from_file(json_path));
+        std::ofstream fs(snapshot_path, std::ios::binary | std::ios::trunc);
+        if (!fs.is_open())
+            throw std::runtime_error(std::string("Unable to open file: ") + snapshot_path);
+
+        fs.write(snapshot.data(), static_cast<std::streamsize>(snapshot.size()));
+        if (!fs)
+            throw std::runtime_error(std::string("Unable to write file: ") + snapshot_path);
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+// 重新加载压力测试：多个线程反复获取快照及Resolve，同时当前线程反复通过LoadGameDataJson重新加载建筑数据，
+// 检查读取方始终得到完整的数据且不出现异常
+static void RunReloadTest(const char *game_data_json, const AlbcTestConfig &config)
+{
+#ifdef ALBC_HAVE_THREADS
+    constexpr int kReloadCnt = 20;
+    const int reader_cnt = std::max(1, config.param);
+    LOG_I("Running reload test with ", reader_cnt, " reader threads and ", kReloadCnt, " reloads");
+
+    const auto reload = [game_data_json]() {
+        AlbcException *e = nullptr;
+        LoadGameDataJson(ALBC_GAME_DATA_DB_BUILDING_DATA, game_data_json, &e);
+        if (e)
+        {
+            const std::string what = e->what;
+            FreeException(e);
+            throw std::runtime_error("Unable to load building data: " + what);
+        }
+    };
+
+    reload();
+    const size_t expected_char_cnt = api::GetGameDataSnapshot()->GetBuildingData()->chars.size();
+
+    std::atomic<bool> done{false};
+    std::atomic<UInt64> read_cnt{0};
+    std::atomic<UInt64> error_cnt{0};
+    const auto reader = [&]() {
+        while (!done.load(std::memory_order_relaxed))
+        {
+            try
+            {
+                const auto snapshot = api::GetGameDataSnapshot();
+                const auto building_data = api::di::Resolve<data::building::BuildingData>();
+                if (snapshot->GetBuildingData()->chars.size() != expected_char_cnt ||
+                    building_data->chars.size() != expected_char_cnt)
+                {
+                    ++error_cnt;
+                }
+
+                if (snapshot->HasCharacterTable())
+                    (void)api::di::Resolve<data::game::ICharacterResolver>();
+                ++read_cnt;
+            }
+            catch (const std::exception &e)
+            {
+                LOG_E("Reload test reader error: ", e.what());
+                ++error_cnt;
+            }
+        }
+    };
+
+    Vector<std::thread> readers;
+    for (int i = 0; i < reader_cnt; ++i)
+        readers.emplace_back(reader);
+
+    const auto join_readers = [&]() {
+        done = true;
+        for (auto &t : readers)
+            t.join();
+    };
+
+    try
+    {
+        for (int i = 0; i < kReloadCnt; ++i)
+            reload();
+    }
+    catch (...)
+    {
+        join_readers();
+        throw;
+    }
+    join_readers();
+
+    LOG_I("Reload test completed: ", read_cnt.load(), " reads, ", kReloadCnt, " reloads, ", error_cnt.load(),
+          " errors.");
+    if (error_cnt > 0)
+        throw std::runtime_error("Reload test failed with " + std::to_string(error_cnt.load()) + " errors");
+#else
+    (void)game_data_json;
+    (void)config;
+    throw std::runtime_error("Reload test requires thread support");
+#endif
+}
+
 ALBC_API void RunTest(const char *game_data_json, const char *player_data_json, const AlbcTestConfig *config,
              AlbcException **e_ptr)
 {
     try
     {
+        if (config->mode == ALBC_TEST_MODE_RELOAD)
+        {
+            RunReloadTest(game_data_json, *config);
+            return;
+        }
+
         const auto &player_data = util::read_json_from_char_array(player_data_json);
         const auto &game_data = util::read_json_from_char_array(game_data_json);
 
@@ -363,6 +483,31 @@ ALBC_API_MEMBER void Model::SetDblParam(AlbcModelParamType type, double value, A
     }
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
 }
+ALBC_API_MEMBER void Model::ForbidCharacter(const char *char_identifier, AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        impl_->ForbidCharacter(char_identifier ? char_identifier : "");
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+ALBC_API_MEMBER void Model::PinCharacter(const char *char_identifier, const char *room_identifier,
+                                         AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        impl_->PinCharacter(char_identifier ? char_identifier : "", room_identifier ? room_identifier : "");
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+ALBC_API_MEMBER void Model::ClearConstraints(AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        impl_->ClearConstraints();
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
 ALBC_API_MEMBER IResult *Model::GetResult(AlbcException **e_ptr) noexcept
 {
     try
@@ -372,6 +517,15 @@ ALBC_API_MEMBER IResult *Model::GetResult(AlbcException **e_ptr) noexcept
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
     return nullptr;
 }
+ALBC_API_MEMBER IAsyncResult *Model::GetResultAsync(AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        return impl_->GetResultAsync();
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+    return nullptr;
+}
 ALBC_API_MEMBER Model::Model(AlbcException **e_ptr) noexcept
 {
     try
@@ -537,15 +691,117 @@ ALBC_API_MEMBER String Room::GetIdentifier(AlbcException **e_ptr) const noexcept
     return String{};
 }
 
+// 编译时启用的最高指令集
+static const char *GetIsaLevel()
+{
+#if defined(__AVX512F__)
+    return "avx512";
+#elif defined(__AVX2__)
+    return "avx2";
+#elif defined(__AVX__)
+    return "avx";
+#elif defined(__SSE4_2__)
+    return "sse4.2";
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return "neon";
+#else
+    return "generic";
+#endif
+}
+
 ALBC_API ICollection<String> *GetInfo(AlbcException **e_ptr)
 {
     try
     {
-        return new ICollectionVectorImpl<String>();
+        // 只读取已有的状态（原子计数、已构造的快照），不触发数据加载或快照构造
+        Vector<std::string> info;
+        const auto add = [&info](const char *key, const auto &value) {
+            std::ostringstream oss;
+            oss << key << '=' << value;
+            info.push_back(oss.str());
+        };
+
+        add("build.isa", GetIsaLevel());
+#ifdef ALBC_HAVE_THREADS
+        add("build.threads", 1);
+#else
+        add("build.threads", 0);
+#endif
+#ifdef ALBC_HAVE_ICU
+        add("build.icu", 1);
+#else
+        add("build.icu", 0);
+#endif
+#ifdef ALBC_DISABLE_THREADED_LOGGING
+        add("build.log_mode", "sync");
+#else
+        add("build.log_mode", "threaded");
+#endif
+        add("runtime.hardware_threads", std::thread::hardware_concurrency());
+
+        const auto &storage = api::GetGlobalGameDataStorage();
+        add("game_data.version", storage.GetVersion());
+        const auto add_game_data_size = [&](const char *key, AlbcGameDataDbType type) {
+            const auto json = storage.Get(type);
+            add(key, json ? static_cast<Int64>(json->size()) : -1);
+        };
+        add_game_data_size("game_data.building_data.entries", ALBC_GAME_DATA_DB_BUILDING_DATA);
+        add_game_data_size("game_data.character_table.entries", ALBC_GAME_DATA_DB_CHARACTER_TABLE);
+        add_game_data_size("game_data.char_meta_table.entries", ALBC_GAME_DATA_DB_CHAR_META_TABLE);
+
+        if (const auto snapshot = api::PeekGameDataSnapshot())
+        {
+            add("snapshot.version", snapshot->GetVersion());
+            if (snapshot->HasBuildingData())
+            {
+                const auto bd = snapshot->GetBuildingData();
+                add("snapshot.building_chars", bd->chars.size());
+                add("snapshot.building_buffs", bd->buffs.size());
+            }
+            if (snapshot->HasCharacterTable())
+                add("snapshot.characters", snapshot->GetCharacterTable()->size());
+        }
+        else
+        {
+            add("snapshot.version", -1);
+        }
+        add("string_interner.size", util::GetGlobalStringInterner().Size());
+
+        auto &result_cache = api::GetGlobalResultCache();
+        add("result_cache.size", result_cache.GetSize());
+        add("result_cache.capacity", result_cache.GetCapacity());
+        add("result_cache.hits", result_cache.GetHitCount());
+        add("result_cache.misses", result_cache.GetMissCount());
+
+        api::GetGlobalSolveStatistics().AppendInfo("stats.", info);
+
+        auto result = new ICollectionVectorImpl<String>();
+        for (const auto &item : info)
+            result->emplace_back(item.c_str());
+        return result;
     }
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
     return nullptr;
 }
+ALBC_API void SetResultCacheCapacity(int capacity, AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        if (capacity < 0)
+            throw std::invalid_argument("invalid argument: capacity: " + std::to_string(capacity));
+
+        api::GetGlobalResultCache().SetCapacity(static_cast<size_t>(capacity));
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+ALBC_API void SetResultCacheDiskPath(const char *path, AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        api::GetGlobalResultCache().SetDiskStorePath(path ? path : "");
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
 ALBC_API bool SetGlobalLocale(const char *locale) noexcept
 {
     if (!util::CheckTargetLocale(locale))
@@ -554,134 +810,174 @@ ALBC_API bool SetGlobalLocale(const char *locale) noexcept
     util::GlobalLocale::SetLocale(locale);
     return true;
 }
-ALBC_API String RunWithJsonParams(const char *json, AlbcException **e_ptr)
+// 由RunWithJsonParams格式的输入生成房间与干员数据，无法生成的房间、干员记录在out_errors中
+static algorithm::iface::CustomPackedInput ResolveJsonInput(const api::JsonInParams &in_params,
+                                                          const api::GameDataSnapshot &snapshot,
+                                                          api::JsonOutErrorStruct &out_errors)
 {
-    using namespace model::buff;
-    try
+    algorithm::iface::CustomPackedInput input;
+    for (const auto& [ident, room_data]: in_params.rooms)
     {
-        auto i_json_reader = api::di::Resolve<api::IJsonReader>();
-        Json::Value in_params_json_obj = i_json_reader->Read(json);
-
-        const api::JsonInParams in_params(in_params_json_obj);
-        api::JsonOutParams out_params;
-        algorithm::iface::CustomPackedInput input;
-
-        for (const auto& [ident, room_data]: in_params.rooms)
+        try
         {
-            try
+            algorithm::iface::CustomRoom room;
+            room.SetType(room_data.type);
+            switch (room_data.type)  // NOLINT(clang-diagnostic-switch-enum)
             {
-                algorithm::iface::CustomRoom room;
-                room.SetType(room_data.type);
-                switch (room_data.type)  // NOLINT(clang-diagnostic-switch-enum)
-                {
-                case data::building::RoomType::MANUFACTURE:
-                    room.room_attributes.prod_type = room_data.prod_type;
-                    break;
-                case data::building::RoomType::TRADING:
-                    room.room_attributes.order_type = room_data.order_type;
-                    break;
-
-                case data::building::RoomType::POWER:
-                case data::building::RoomType::DORMITORY:
-                    break;
-
-                default:
-                    LOG_E("Room: ", ident, " has unrecognized type: ", util::enum_to_string(room_data.type));
-                    break;
-                }
+            case data::building::RoomType::MANUFACTURE:
+                room.room_attributes.prod_type = room_data.prod_type;
+                break;
+            case data::building::RoomType::TRADING:
+                room.room_attributes.order_type = room_data.order_type;
+                break;
 
-                auto& attr = room.room_attributes;
-                attr.prod_cnt = room_data.attributes.prod_cnt;
-                attr.base_prod_eff = room_data.attributes.base_prod_eff;
-                attr.base_prod_cap = room_data.attributes.base_prod_cap;
-                attr.base_char_cost = room_data.attributes.base_char_cost;
+            case data::building::RoomType::POWER:
+            case data::building::RoomType::DORMITORY:
+                break;
 
-                room.SetIdentifier(ident);
-                if (room_data.type != data::building::RoomType::DORMITORY)
-                {
-                    room.SetMaxSlotCnt(room_data.slot_count);
-                    room.SetLevel(std::max(room_data.level, room_data.slot_count));
-                }
-                else
-                {
-                    room.SetMaxSlotCnt(5);
-                    room.SetLevel(room_data.level);
-                }
+            default:
+                LOG_E("Room: ", ident, " has unrecognized type: ", util::enum_to_string(room_data.type));
+                break;
+            }
 
-                if (auto opt_room_data = room.GenerateRoomData())
-                    input.rooms.emplace_back(std::move(*opt_room_data));
-                else
-                    throw std::runtime_error("failed to generate room data");
+            auto& attr = room.room_attributes;
+            attr.prod_cnt = room_data.attributes.prod_cnt;
+            attr.base_prod_eff = room_data.attributes.base_prod_eff;
+            attr.base_prod_cap = room_data.attributes.base_prod_cap;
+            attr.base_char_cost = room_data.attributes.base_char_cost;
+
+            room.SetIdentifier(ident);
+            if (room_data.type != data::building::RoomType::DORMITORY)
+            {
+                room.SetMaxSlotCnt(room_data.slot_count);
+                room.SetLevel(std::max(room_data.level, room_data.slot_count));
             }
-            catch (const std::exception& e)
+            else
             {
-                LOG_E("Error creating room: ", ident, ": ", e.what());
-                out_params.errors.rooms[ident] = e.what();
+                room.SetMaxSlotCnt(5);
+                room.SetLevel(room_data.level);
             }
+
+            if (auto opt_room_data = room.GenerateRoomData())
+                input.rooms.emplace_back(std::move(*opt_room_data));
+            else
+                throw std::runtime_error("failed to generate room data");
+        }
+        catch (const std::exception& e)
+        {
+            LOG_E("Error creating room: ", ident, ": ", e.what());
+            out_errors.rooms[ident] = e.what();
         }
+    }
 
-        auto i_slt = api::di::Resolve<data::game::ISkillLookupTable>();
-        auto cmt = api::di::Resolve<data::game::CharacterMetaTable>();
-        auto i_cr = api::di::Resolve<data::game::ICharacterResolver>();
-        for (const auto& [ident, char_data]: in_params.chars)
+    auto i_slt = snapshot.GetSkillLookupTable();
+    auto cmt = snapshot.GetCharacterMetaTable();
+    auto i_cr = snapshot.GetCharacterResolver();
+    for (const auto& [ident, char_data]: in_params.chars)
+    {
+        try
         {
-            try
-            {
-                algorithm::iface::CustomCharacter character(i_cr, cmt);
+            algorithm::iface::CustomCharacter character(i_cr, cmt);
 
-                character.SetIdentifier(ident);
+            character.SetIdentifier(ident);
 
-                if (!char_data.name.empty())
-                    character.SetIdResolveCond(char_data.name, data::game::CharIdentifierType::NAME);
-                else if (!char_data.id.empty())
-                    character.SetIdResolveCond(char_data.id, data::game::CharIdentifierType::ID);
+            if (!char_data.name.empty())
+                character.SetIdResolveCond(char_data.name, data::game::CharIdentifierType::NAME);
+            else if (!char_data.id.empty())
+                character.SetIdResolveCond(char_data.id, data::game::CharIdentifierType::ID);
 
-                if (char_data.phase > 2 || char_data.level > 90)
-                    throw std::invalid_argument(std::string("invalid argument: ") +
-                                                "phase: " + std::to_string(char_data.phase) +
-                                                ", level: " + std::to_string(char_data.level));
+            if (char_data.phase > 2 || char_data.level > 90)
+                throw std::invalid_argument(std::string("invalid argument: ") +
+                                            "phase: " + std::to_string(char_data.phase) +
+                                            ", level: " + std::to_string(char_data.level));
 
-                if (char_data.phase >= 0 && char_data.level >= 0)
-                    character.SetLevelCond((data::EvolvePhase)char_data.phase, char_data.level);
+            if (char_data.phase >= 0 && char_data.level >= 0)
+                character.SetLevelCond((data::EvolvePhase)char_data.phase, char_data.level);
 
-                for (const auto& skill_ident: char_data.skills)
-                {
-                    if (i_slt->HasId(skill_ident))
-                        character.AddSkillById(skill_ident);
-                    else if (i_slt->HasName(skill_ident))
-                        character.AddSkillByName(skill_ident);
-                    else if (i_slt->HasIcon(skill_ident))
-                        character.AddSkillByIcon(skill_ident);
-                    else
-                        LOG_W("Unrecognized skill: ", skill_ident, " of character: ", ident);
-                }
-
-                character.SetMorale(char_data.morale);
-                if (auto opt_char_data = character.GenerateCharacterData())
-                    input.characters.emplace_back(std::move(*opt_char_data));
-                else
-                    throw std::runtime_error("failed to generate character data");
-            }
-            catch (const std::exception& e)
+            for (const auto& skill_ident: char_data.skills)
             {
-                LOG_E("Error creating character: ", ident, ": ", e.what());
-                out_params.errors.chars[ident] = e.what();
+                if (i_slt->HasId(skill_ident))
+                    character.AddSkillById(skill_ident);
+                else if (i_slt->HasName(skill_ident))
+                    character.AddSkillByName(skill_ident);
+                else if (i_slt->HasIcon(skill_ident))
+                    character.AddSkillByIcon(skill_ident);
+                else
+                    LOG_W("Unrecognized skill: ", skill_ident, " of character: ", ident);
             }
+
+            character.SetMorale(char_data.morale);
+            if (auto opt_char_data = character.GenerateCharacterData())
+                input.characters.emplace_back(std::move(*opt_char_data));
+            else
+                throw std::runtime_error("failed to generate character data");
+        }
+        catch (const std::exception& e)
+        {
+            LOG_E("Error creating character: ", ident, ": ", e.what());
+            out_errors.chars[ident] = e.what();
         }
+    }
+    return input;
+}
+
+static AlbcSolverParameters MakeSolverParameters(const api::JsonInParams &in_params)
+{
+    AlbcSolverParameters solver_params {};
+    solver_params.solve_time_limit = in_params.solve_time_limit;
+    solver_params.model_time_limit = in_params.model_time_limit;
+    solver_params.gen_all_solution_details = in_params.gen_sol_details;
+    solver_params.gen_lp_file = in_params.gen_lp_file;
+    solver_params.solution_pool_size = in_params.solution_pool_size;
+    solver_params.marginal_value_mode = in_params.marginal_value_mode;
+    return solver_params;
+}
 
-        const auto bd = api::di::Resolve<data::building::BuildingData>();
-        algorithm::iface::AlgorithmParams alg_params(input, *bd);
+// 按RunWithJsonParams的输入求解，所有游戏数据取自同一个快照
+static Json::Value RunWithJsonParamsImpl(std::string_view json, const api::GameDataSnapshot &snapshot)
+{
+    auto i_json_reader = api::di::Resolve<api::IJsonReader>();
+    Json::Value in_params_json_obj = i_json_reader->Read(json);
+
+    const api::JsonInParams in_params(in_params_json_obj);
+    api::JsonOutParams out_params;
+    const auto resolve_start = util::PerfClock::now();
+    const auto input = ResolveJsonInput(in_params, snapshot, out_params.errors);
+    const double resolve_seconds = util::FloatingSeconds(util::PerfClock::now() - resolve_start).count();
+
+    algorithm::OperatorConstraints constraints;
+    constraints.forbidden_ops.insert(in_params.forbidden_chars.begin(), in_params.forbidden_chars.end());
+    constraints.pinned_ops = in_params.pinned_chars;
+
+    const auto solver_params = MakeSolverParameters(in_params);
+
+    auto& result_cache = api::GetGlobalResultCache();
+    const bool use_cache = api::ResultCache::IsCacheable(solver_params);
+    const auto cache_key_material =
+        api::ResultCache::MakeKeyMaterial(input, solver_params, constraints, snapshot.GetContentDigest());
+    if (api::JsonOutParams cached_params; use_cache && result_cache.TryGet(cache_key_material, cached_params))
+    {
+        LOG_I("Result cache hit: ", api::ResultCache::MakeKey(cache_key_material));
+        cached_params.errors = std::move(out_params.errors);
+        cached_params.metrics = {};
+        cached_params.metrics.cache_hit = true;
+        cached_params.metrics.metrics.resolve_seconds = resolve_seconds;
+        return static_cast<Json::Value>(cached_params);
+    }
 
-        const auto i_runner = api::di::Resolve<algorithm::iface::IRunner>();
-        algorithm::AlgorithmResult result;
-        AlbcSolverParameters solver_params {};
-        solver_params.solve_time_limit = in_params.solve_time_limit;
-        solver_params.model_time_limit = in_params.model_time_limit;
-        solver_params.gen_all_solution_details = in_params.gen_sol_details;
-        solver_params.gen_lp_file = in_params.gen_lp_file;
+    const auto bd = snapshot.GetBuildingData();
+    const auto params_start = util::PerfClock::now();
+    algorithm::iface::AlgorithmParams alg_params(input, *bd);
+    alg_params.SetConstraints(std::move(constraints));
+    const double params_seconds = util::FloatingSeconds(util::PerfClock::now() - params_start).count();
 
-        i_runner->Run(alg_params, solver_params, result);
-        for (const auto& room: result.rooms)
+    const auto i_runner = api::di::Resolve<algorithm::iface::IRunner>();
+    algorithm::AlgorithmResult result;
+    i_runner->Run(alg_params, solver_params, result);
+    const auto fill_out_rooms = [](const Vector<algorithm::RoomResult>& rooms,
+                                   Dictionary<std::string, api::JsonOutRoomStruct>& out_rooms)
+    {
+        for (const auto& room: rooms)
         {
             api::JsonOutRoomStruct out_room;
             out_room.score = room.solution.productivity;
@@ -690,16 +986,155 @@ ALBC_API String RunWithJsonParams(const char *json, AlbcException **e_ptr)
                 if (op)
                     out_room.chars.emplace_back(op->identifier);
 
-            out_params.rooms.emplace(room.room->id, std::move(out_room));
+            out_rooms.emplace(room.room->id, std::move(out_room));
         }
+    };
+
+    fill_out_rooms(result.rooms, out_params.rooms);
+    for (const auto& alternative: result.alternatives)
+        fill_out_rooms(alternative, out_params.alternatives.emplace_back());
+
+    out_params.marginal_values = std::move(result.marginal_values);
+    out_params.metrics.metrics = std::move(result.metrics);
+    out_params.metrics.metrics.resolve_seconds = resolve_seconds;
+    out_params.metrics.metrics.params_seconds = params_seconds;
+    api::GetGlobalSolveStatistics().Record(out_params.metrics.metrics);
+
+    if (use_cache)
+        result_cache.Put(cache_key_material, out_params);
+
+    return static_cast<Json::Value>(out_params);
+}
+
+// 按RunWithJsonParams的输入估计组合数与内存占用，不求解
+static Json::Value EstimateWithJsonParamsImpl(std::string_view json, const api::GameDataSnapshot &snapshot)
+{
+    const auto i_json_reader = api::di::Resolve<api::IJsonReader>();
+    const api::JsonInParams in_params(i_json_reader->Read(json));
+    api::JsonOutEstimateStruct out_estimate;
+    const auto input = ResolveJsonInput(in_params, snapshot, out_estimate.errors);
 
-        auto i_json_writer = api::di::Resolve<api::IJsonWriter>();
-        return String { i_json_writer->Write(static_cast<Json::Value>(out_params)).c_str() };
+    const algorithm::iface::AlgorithmParams alg_params(input, *snapshot.GetBuildingData());
+    algorithm::iface::EstimateComb(alg_params, out_estimate.estimate);
+    const auto strategy = algorithm::iface::SelectSolveStrategy(out_estimate.estimate, MakeSolverParameters(in_params));
+    out_estimate.greedy = strategy.greedy;
+    out_estimate.marginal_value_mode = strategy.marginal_value_mode;
+    return static_cast<Json::Value>(out_estimate);
+}
+
+ALBC_API String RunWithJsonParams(const char *json, AlbcException **e_ptr)
+{
+    try
+    {
+        const auto i_json_writer = api::di::Resolve<api::IJsonWriter>();
+        return String { i_json_writer->Write(RunWithJsonParamsImpl(json, *api::GetGameDataSnapshot())).c_str() };
     }
     ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
     return String("{}");
 }
 
+ALBC_API void RunWithJsonParamsTo(const char *json, size_t json_len, AlbcWriteHandler handler, void *user_data,
+                                  AlbcException **e_ptr)
+{
+    try
+    {
+        if (json == nullptr && json_len > 0)
+            throw std::invalid_argument("invalid argument: json is null");
+        if (handler == nullptr)
+            throw std::invalid_argument("invalid argument: handler is null");
+
+        const auto out_json = RunWithJsonParamsImpl(std::string_view(json, json_len), *api::GetGameDataSnapshot());
+
+        // 序列化结果分块直接交给调用者，不经过中间字符串及编码转换
+        api::CallbackStreamBuf buf(handler, user_data);
+        std::ostream os(&buf);
+        api::di::Resolve<api::IJsonWriter>()->Write(out_json, os);
+        if (!os.flush())
+            throw std::runtime_error("output aborted by write handler");
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+
+ALBC_API String EstimateWithJsonParams(const char *json, AlbcException **e_ptr)
+{
+    try
+    {
+        if (json == nullptr)
+            throw std::invalid_argument("invalid argument: json is null");
+
+        const auto i_json_writer = api::di::Resolve<api::IJsonWriter>();
+        return String { i_json_writer->Write(EstimateWithJsonParamsImpl(json, *api::GetGameDataSnapshot())).c_str() };
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+    return String("{}");
+}
+
+ALBC_API ICollection<IBatchResult *> *RunBatchWithJsonParams(int n, const char *const *jsons, int thread_count,
+                                                             AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        if (n < 0 || (n > 0 && jsons == nullptr))
+            throw std::invalid_argument("invalid argument: n: " + std::to_string(n));
+
+        // 整批只取一次快照，批内游戏数据更新不影响正在进行的求解
+        const auto snapshot = api::GetGameDataSnapshot();
+        auto results = std::make_unique<BatchResultCollectionImpl>();
+        results->resize(n, nullptr);
+
+        const auto i_json_writer = api::di::Resolve<api::IJsonWriter>();
+        std::atomic<int> next_index{0};
+        const auto worker = [&]() {
+            for (int i = next_index++; i < n; i = next_index++)
+            {
+                BatchResultImpl *item = nullptr;
+                const auto start = std::chrono::steady_clock::now();
+                try
+                {
+                    item = new BatchResultImpl();
+                    (*results)[i] = item;
+                    if (jsons[i] == nullptr)
+                        throw std::invalid_argument("invalid argument: null json at index " + std::to_string(i));
+
+                    item->output = i_json_writer->Write(RunWithJsonParamsImpl(jsons[i], *snapshot));
+                }
+                catch (const std::exception &e)
+                {
+                    LOG_E("Error solving batch item #", i, ": ", e.what());
+                    if (!item)
+                        continue; // 结果对象本身分配失败，该项保留为空指针
+                    item->status = 1;
+                    item->output = "{}";
+                    item->error_message = e.what();
+                }
+                item->elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+        };
+
+        auto &pool = util::GetSharedThreadPool();
+        const int pool_size = static_cast<int>(pool.Size());
+        const int worker_count = std::min(n, thread_count > 0 ? std::min(thread_count, pool_size) : pool_size);
+        Vector<std::future<void>> futures;
+        futures.reserve(worker_count);
+        {
+            // 提交中途失败时也要等已提交的任务结束，它们引用了本函数的局部变量
+            const auto &wait_all = util::make_defer([&futures]() {
+                for (auto &f : futures)
+                    f.wait();
+            });
+            for (int i = 0; i < worker_count; ++i)
+                futures.push_back(pool.Submit(worker));
+        }
+
+        for (auto &f : futures)
+            f.get();
+
+        return results.release();
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+    return nullptr;
+}
+
 } // namespace albc
 
 #pragma clang diagnostic pop
\ No newline at end of file
@@ -110,3 +110,60 @@ CALBC_API AlbcString *AlbcRunWithJsonParams(const char *json, AlbcException **e_
 {
     return new AlbcString(new albc::String(albc::RunWithJsonParams(json, e_ptr)));
 }
+
+CALBC_API void AlbcRunWithJsonParamsTo(const char *json, size_t json_len, AlbcWriteHandler handler, void *user_data,
+                                       AlbcException **e_ptr)
+{
+    albc::RunWithJsonParamsTo(json, json_len, handler, user_data, e_ptr);
+}
+
+CALBC_API AlbcString *AlbcEstimateWithJsonParams(const char *json, AlbcException **e_ptr)
+{
+    return new AlbcString(new albc::String(albc::EstimateWithJsonParams(json, e_ptr)));
+}
+
+CALBC_API void AlbcRunBatchWithJsonParams(int n, const char *const *jsons, int thread_count,
+                                          AlbcBatchResult *out_results, AlbcException **e_ptr)
+{
+    try
+    {
+        if (n > 0 && out_results == nullptr)
+            throw std::invalid_argument("invalid argument: out_results is null");
+
+        std::unique_ptr<albc::ICollection<albc::IBatchResult *>> results(
+            albc::RunBatchWithJsonParams(n, jsons, thread_count, e_ptr));
+        if (!results)
+            return;
+
+        int i = 0;
+        for (const auto *item : *results)
+        {
+            if (!item)
+            {
+                out_results[i++] = AlbcBatchResult{1, 0, nullptr, nullptr};
+                continue;
+            }
+            out_results[i].status = item->GetStatus();
+            out_results[i].elapsed_seconds = item->GetElapsedSeconds();
+            out_results[i].output = new AlbcString(new albc::String(item->GetOutput()));
+            out_results[i].error = new AlbcString(new albc::String(item->GetErrorMessage()));
+            ++i;
+        }
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+}
+
+CALBC_API void AlbcSetResultCacheCapacity(int capacity, AlbcException **e_ptr)
+{
+    albc::SetResultCacheCapacity(capacity, e_ptr);
+}
+
+CALBC_API void AlbcSetResultCacheDiskPath(const char *path, AlbcException **e_ptr)
+{
+    albc::SetResultCacheDiskPath(path, e_ptr);
+}
+
+CALBC_API void AlbcCompileGameDataSnapshot(const char *json_path, const char *snapshot_path, AlbcException **e_ptr)
+{
+    albc::CompileGameDataSnapshot(json_path, snapshot_path, e_ptr);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "api_game_data_snapshot.h"
 #include "api_resource.h"
 #include "api_storage.h"
 #include "boost/di.hpp"
@@ -18,12 +19,12 @@ namespace albc::api::di
 static const auto& GetInjector()
 {
     static auto injector = make_injector(
-        boost::di::bind<data::building::BuildingData>().to([] { return GetGlobalGameDataStorage().Resolve<data::building::BuildingData>(ALBC_GAME_DATA_DB_BUILDING_DATA); }),
-        boost::di::bind<data::game::CharacterTable>().to([] { return GetGlobalGameDataStorage().Resolve<data::game::CharacterTable>(ALBC_GAME_DATA_DB_CHARACTER_TABLE); }),
-        boost::di::bind<data::game::CharacterMetaTable>().to([] { return GetGlobalGameDataStorage().Resolve<data::game::CharacterMetaTable>(ALBC_GAME_DATA_DB_CHAR_META_TABLE); }),
-        boost::di::bind<data::game::ICharacterLookupTable>().to<data::game::CharacterLookupTable>(),
-        boost::di::bind<data::game::ISkillLookupTable>().to<data::game::SkillLookupTable>(),
-        boost::di::bind<data::game::ICharacterResolver>().to<data::game::CharacterResolver>(),
+        boost::di::bind<data::building::BuildingData>().to([] { return GetGameDataSnapshot()->GetBuildingData(); }),
+        boost::di::bind<data::game::CharacterTable>().to([] { return GetGameDataSnapshot()->GetCharacterTable(); }),
+        boost::di::bind<data::game::CharacterMetaTable>().to([] { return GetGameDataSnapshot()->GetCharacterMetaTable(); }),
+        boost::di::bind<data::game::ICharacterLookupTable>().to([] { return GetGameDataSnapshot()->GetCharacterLookupTable(); }),
+        boost::di::bind<data::game::ISkillLookupTable>().to([] { return GetGameDataSnapshot()->GetSkillLookupTable(); }),
+        boost::di::bind<data::game::ICharacterResolver>().to([] { return GetGameDataSnapshot()->GetCharacterResolver(); }),
         boost::di::bind<algorithm::iface::IRunner>().to<algorithm::iface::MultiRoomIntegerProgramRunner>().in(boost::di::singleton),
         boost::di::bind<IJsonWriter>().to<JsonWriter>().in(boost::di::singleton),
         boost::di::bind<IJsonReader>().to<JsonReader>().in(boost::di::singleton));
@@ -32,20 +33,33 @@ static const auto& GetInjector()
 }
 #pragma clang diagnostic pop
 
+// 可并发调用。实例与其对应的资源版本作为一个整体原子地发布，版本未变化时只进行一次原子读取
 template <typename TGet>
 inline std::shared_ptr<TGet> Resolve()
 {
-    static std::atomic<UInt32> resource_version{UINT32_MAX};
-    static std::shared_ptr<TGet> instance;
+    struct Entry
+    {
+        UInt32 version;
+        std::shared_ptr<TGet> instance;
+    };
+    static std::shared_ptr<const Entry> current;
 
     try
     {
-        if (resource_version != GetGlobalGameDataStorage().GetVersion())
+        // 以发布的快照版本为准：存储的版本号先于快照更新，以它为准会把旧快照中的实例记为新版本
+        const UInt32 version = GetGameDataSnapshot()->GetVersion();
+        auto entry = std::atomic_load(&current);
+        if (entry && entry->version == version)
+            return entry->instance;
+
+        // 多个线程可能同时构造新实例，只保留版本最新的一个，不会用旧版本覆盖新版本
+        auto new_entry = std::make_shared<const Entry>(Entry{version, GetInjector().template create<std::shared_ptr<TGet>>()});
+        while (!entry || entry->version < version)
         {
-            instance = GetInjector().template create<std::shared_ptr<TGet>>();
-            resource_version = GetGlobalGameDataStorage().GetVersion();
+            if (std::atomic_compare_exchange_weak(&current, &entry, new_entry))
+                break;
         }
-        return instance;
+        return new_entry->instance;
     }
     catch (const std::exception& e)
     {
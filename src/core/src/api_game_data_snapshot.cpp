@@ -0,0 +1,226 @@
+#include "api_game_data_snapshot.h"
+#include "api_storage.h"
+#include "util_time.h"
+
+#include <mutex>
+
+namespace albc::api
+{
+namespace
+{
+template <typename T>
+std::shared_ptr<T> CheckResolvable(const std::shared_ptr<T> &ptr)
+{
+    if (!ptr)
+    {
+        throw std::runtime_error(std::string("Resource of type: ")
+                                     .append(util::TypeName<T>())
+                                     .append(" not resolvable: required game data not loaded"));
+    }
+    return ptr;
+}
+
+// 按Json树的结构计算FNV-1a摘要。对象成员按键名有序遍历，数值按其二进制表示参与计算，结果与序列化格式无关
+UInt64 DigestJson(const Json::Value &json, UInt64 seed)
+{
+    const auto put = [&seed](const auto &value) { seed = util::fnv1a64(&value, sizeof(value), seed); };
+
+    const auto type = static_cast<int>(json.type());
+    put(type);
+    switch (json.type())
+    {
+    case Json::intValue:
+        put(json.asInt64());
+        break;
+
+    case Json::uintValue:
+        put(json.asUInt64());
+        break;
+
+    case Json::realValue:
+        put(json.asDouble());
+        break;
+
+    case Json::booleanValue:
+        put(json.asBool());
+        break;
+
+    case Json::stringValue: {
+        const char *begin = nullptr;
+        const char *end = nullptr;
+        json.getString(&begin, &end);
+        put(static_cast<UInt64>(end - begin));
+        seed = util::fnv1a64(begin, static_cast<size_t>(end - begin), seed);
+        break;
+    }
+
+    case Json::arrayValue:
+    case Json::objectValue:
+        put(static_cast<UInt64>(json.size()));
+        for (auto it = json.begin(); it != json.end(); ++it)
+        {
+            if (json.isObject())
+            {
+                const char *end = nullptr;
+                const char *begin = it.memberName(&end);
+                put(static_cast<UInt64>(end - begin));
+                seed = util::fnv1a64(begin, static_cast<size_t>(end - begin), seed);
+            }
+            seed = DigestJson(*it, seed);
+        }
+        break;
+
+    default:
+        break;
+    }
+    return seed;
+}
+
+UInt64 DigestTables(const GameDataJsonTables &tables)
+{
+    UInt64 digest = util::kFnv1a64Offset;
+    for (const auto *table : {&tables.building_data, &tables.character_table, &tables.char_meta_table})
+    {
+        const bool present = *table != nullptr;
+        digest = util::fnv1a64(&present, sizeof(present), digest);
+        if (present)
+            digest = DigestJson(**table, digest);
+    }
+    return digest;
+}
+
+template <typename T>
+std::shared_ptr<T> ConstructTable(AlbcGameDataDbType index, const std::shared_ptr<Json::Value> &json)
+{
+    if (!json)
+        return nullptr;
+
+    try
+    {
+        return std::make_shared<T>(*json);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_E("Resource resolve failed: index: ", util::enum_to_string(index), " type: ", util::TypeName<T>(),
+              " , error: ", e.what());
+        throw;
+    }
+}
+} // namespace
+
+GameDataJsonTables GameDataJsonTables::FromStorage(const GameDataJsonStorage &storage)
+{
+    GameDataJsonTables tables;
+    tables.building_data = storage.Get(ALBC_GAME_DATA_DB_BUILDING_DATA);
+    tables.character_table = storage.Get(ALBC_GAME_DATA_DB_CHARACTER_TABLE);
+    tables.char_meta_table = storage.Get(ALBC_GAME_DATA_DB_CHAR_META_TABLE);
+    return tables;
+}
+
+std::shared_ptr<const GameDataSnapshot> GameDataSnapshot::Build(UInt32 version, const GameDataJsonTables &tables)
+{
+    const auto sc = SCOPE_TIMER_WITH_TRACE("Building game data snapshot");
+    auto snapshot = std::make_shared<GameDataSnapshot>();
+    snapshot->version_ = version;
+    snapshot->content_digest_ = DigestTables(tables);
+    snapshot->building_data_ =
+        ConstructTable<data::building::BuildingData>(ALBC_GAME_DATA_DB_BUILDING_DATA, tables.building_data);
+    snapshot->character_table_ =
+        ConstructTable<data::game::CharacterTable>(ALBC_GAME_DATA_DB_CHARACTER_TABLE, tables.character_table);
+    snapshot->character_meta_table_ =
+        ConstructTable<data::game::CharacterMetaTable>(ALBC_GAME_DATA_DB_CHAR_META_TABLE, tables.char_meta_table);
+
+    if (snapshot->building_data_ && snapshot->character_table_)
+    {
+        snapshot->character_lookup_table_ = std::make_shared<data::game::CharacterLookupTable>(
+            snapshot->character_table_, snapshot->building_data_);
+        snapshot->skill_lookup_table_ = std::make_shared<data::game::SkillLookupTable>(
+            snapshot->building_data_, snapshot->character_lookup_table_);
+        snapshot->character_resolver_ = std::make_shared<data::game::CharacterResolver>(
+            snapshot->skill_lookup_table_, snapshot->character_lookup_table_);
+    }
+
+    return snapshot;
+}
+
+std::shared_ptr<data::building::BuildingData> GameDataSnapshot::GetBuildingData() const
+{
+    return CheckResolvable(building_data_);
+}
+
+std::shared_ptr<data::game::CharacterTable> GameDataSnapshot::GetCharacterTable() const
+{
+    return CheckResolvable(character_table_);
+}
+
+std::shared_ptr<data::game::CharacterMetaTable> GameDataSnapshot::GetCharacterMetaTable() const
+{
+    return CheckResolvable(character_meta_table_);
+}
+
+std::shared_ptr<data::game::ICharacterLookupTable> GameDataSnapshot::GetCharacterLookupTable() const
+{
+    return CheckResolvable(character_lookup_table_);
+}
+
+std::shared_ptr<data::game::ISkillLookupTable> GameDataSnapshot::GetSkillLookupTable() const
+{
+    return CheckResolvable(skill_lookup_table_);
+}
+
+std::shared_ptr<data::game::ICharacterResolver> GameDataSnapshot::GetCharacterResolver() const
+{
+    return CheckResolvable(character_resolver_);
+}
+
+namespace
+{
+std::shared_ptr<const GameDataSnapshot> current_snapshot;
+std::mutex snapshot_build_mutex; // 只由写入方持有
+} // namespace
+
+void LoadGameData(AlbcGameDataDbType data_type, Json::Value json)
+{
+    auto &storage = GetGlobalGameDataStorage();
+    auto store = std::make_shared<Json::Value>(std::move(json));
+
+    std::lock_guard<std::mutex> lock(snapshot_build_mutex);
+    auto tables = GameDataJsonTables::FromStorage(storage);
+    switch (data_type)
+    {
+    case ALBC_GAME_DATA_DB_BUILDING_DATA:
+        tables.building_data = store;
+        break;
+
+    case ALBC_GAME_DATA_DB_CHARACTER_TABLE:
+        tables.character_table = store;
+        break;
+
+    case ALBC_GAME_DATA_DB_CHAR_META_TABLE:
+        tables.char_meta_table = store;
+        break;
+
+    default:
+        break;
+    }
+
+    // 版本号只在持有锁时更新，新快照的版本号即为替换后存储的版本号
+    auto snapshot = GameDataSnapshot::Build(storage.GetVersion() + 1, tables);
+    storage.Replace(data_type, std::move(store));
+    std::atomic_store(&current_snapshot, std::shared_ptr<const GameDataSnapshot>(std::move(snapshot)));
+}
+
+std::shared_ptr<const GameDataSnapshot> GetGameDataSnapshot()
+{
+    if (auto snapshot = std::atomic_load(&current_snapshot))
+        return snapshot;
+
+    static const auto empty_snapshot = GameDataSnapshot::Build(0, {});
+    return empty_snapshot;
+}
+
+std::shared_ptr<const GameDataSnapshot> PeekGameDataSnapshot()
+{
+    return std::atomic_load(&current_snapshot);
+}
+} // namespace albc::api
@@ -0,0 +1,83 @@
+#pragma once
+#include "api_resource.h"
+#include "data_building.h"
+#include "data_character_lookup_table.h"
+#include "data_character_meta_table.h"
+#include "data_character_resolver.h"
+#include "data_character_table.h"
+#include "data_skill_lookup_table.h"
+
+#include <memory>
+
+namespace albc::api
+{
+// 构造快照所用的各数据表Json。每个表的指针只读取一次，摘要与数据表均由这同一组对象计算
+struct GameDataJsonTables
+{
+    std::shared_ptr<Json::Value> building_data;
+    std::shared_ptr<Json::Value> character_table;
+    std::shared_ptr<Json::Value> char_meta_table;
+
+    [[nodiscard]] static GameDataJsonTables FromStorage(const GameDataJsonStorage &storage);
+};
+
+/**
+ * @brief 某一版本游戏数据的不可变快照
+ *
+ * 一次性由存储中的全部Json构造出各数据表以及依赖它们的查找表，之后只读。
+ * 缺少某个数据表时，依赖它的对象不会被构造，获取时抛出异常。
+ * 版本号只在进程内有效；内容摘要由各数据表的Json内容计算，跨进程稳定，可用于持久化的缓存键。
+ */
+class GameDataSnapshot
+{
+  public:
+    [[nodiscard]] static std::shared_ptr<const GameDataSnapshot> Build(UInt32 version, const GameDataJsonTables &tables);
+
+    [[nodiscard]] UInt32 GetVersion() const noexcept
+    {
+        return version_;
+    }
+
+    [[nodiscard]] UInt64 GetContentDigest() const noexcept
+    {
+        return content_digest_;
+    }
+
+    [[nodiscard]] bool HasBuildingData() const noexcept
+    {
+        return building_data_ != nullptr;
+    }
+
+    [[nodiscard]] bool HasCharacterTable() const noexcept
+    {
+        return character_table_ != nullptr;
+    }
+
+    [[nodiscard]] std::shared_ptr<data::building::BuildingData> GetBuildingData() const;
+    [[nodiscard]] std::shared_ptr<data::game::CharacterTable> GetCharacterTable() const;
+    [[nodiscard]] std::shared_ptr<data::game::CharacterMetaTable> GetCharacterMetaTable() const;
+    [[nodiscard]] std::shared_ptr<data::game::ICharacterLookupTable> GetCharacterLookupTable() const;
+    [[nodiscard]] std::shared_ptr<data::game::ISkillLookupTable> GetSkillLookupTable() const;
+    [[nodiscard]] std::shared_ptr<data::game::ICharacterResolver> GetCharacterResolver() const;
+
+  private:
+    UInt32 version_ = 0;
+    UInt64 content_digest_ = 0;
+    std::shared_ptr<data::building::BuildingData> building_data_;
+    std::shared_ptr<data::game::CharacterTable> character_table_;
+    std::shared_ptr<data::game::CharacterMetaTable> character_meta_table_;
+    std::shared_ptr<data::game::ICharacterLookupTable> character_lookup_table_;
+    std::shared_ptr<data::game::ISkillLookupTable> skill_lookup_table_;
+    std::shared_ptr<data::game::ICharacterResolver> character_resolver_;
+};
+
+// 写入一个数据表，并在写入方构造新版本的快照后原子地发布。写入方之间互斥；
+// 构造失败时抛出异常，存储与当前快照均保持不变
+void LoadGameData(AlbcGameDataDbType data_type, Json::Value json);
+
+// 获取当前发布的快照，只进行一次原子读取，不会构造快照也不会阻塞。尚未加载游戏数据时返回空快照
+[[nodiscard]] std::shared_ptr<const GameDataSnapshot> GetGameDataSnapshot();
+
+// 获取当前发布的快照。尚未加载游戏数据时返回空指针
+[[nodiscard]] std::shared_ptr<const GameDataSnapshot> PeekGameDataSnapshot();
+} // namespace albc::api
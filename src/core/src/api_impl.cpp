@@ -3,8 +3,14 @@
 //
 #include "api_impl.h"
 #include "albc/albc_common.h"
+#include "api_json_params.h"
+#include "api_statistics.h"
+#include "util_json_stream.h"
+#include "util_mmap.h"
 #include "util_time.h"
 
+#include <cstring>
+
 namespace albc
 {
 
@@ -33,7 +39,7 @@ int CharQueryImpl::Level() const noexcept
     return item.level;
 }
 ResultImpl::ResultImpl(int status_val, ICollectionVectorImpl<IRoomResult *> *rooms_val)
-    : status(status_val), rooms(rooms_val)
+    : status(status_val), rooms(rooms_val), alternatives(new ICollectionVectorImpl<IResult *>())
 {
 }
 int ResultImpl::GetStatus() const noexcept
@@ -44,18 +50,60 @@ ICollection<IRoomResult *> *ResultImpl::GetRoomDetails() const noexcept
 {
     return rooms;
 }
+ICollection<IResult *> *ResultImpl::GetAlternatives() const noexcept
+{
+    return alternatives;
+}
+double ResultImpl::GetMarginalValue(const char *char_identifier) const noexcept
+{
+    if (!char_identifier)
+        return -1;
+
+    const auto it = marginal_values.find(char_identifier);
+    return it != marginal_values.end() ? it->second : -1;
+}
+// 在统计的Json表示中按名称查找数值项，使接口与RunWithJsonParams的输出使用同一套名称
+static double FindMetric(const Json::Value &metrics_val, const char *name) noexcept
+{
+    if (!name || !metrics_val.isObject())
+        return -1;
+
+    const Json::Value *val = metrics_val.find(name, name + std::strlen(name));
+    if (!val || !(val->isNumeric() || val->isBool()))
+        return -1;
+
+    return val->asDouble();
+}
+double ResultImpl::GetMetric(const char *name) const noexcept
+{
+    try
+    {
+        return FindMetric(static_cast<Json::Value>(api::JsonOutMetricsStruct{metrics}), name);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_E("Failed to get metric: ", e.what());
+        return -1;
+    }
+}
 ResultImpl::~ResultImpl()
 {
     mem::free_ptr_vector(*rooms);
     delete rooms;
+    mem::free_ptr_vector(*alternatives);
+    delete alternatives;
 }
 RoomResultImpl::RoomResultImpl(String id_val, ICollectionVectorImpl<String> *char_identifiers_val,
-                               double estimated_score_val, double duration_val, String readable_info_val)
+                               double estimated_score_val, double duration_val,
+                               std::shared_ptr<const SolveOutput> source, const algorithm::RoomResult *room_result,
+                               const algorithm::RoomSolveMetrics &metrics)
     : id_(std::move(id_val)),
       char_identifiers_(char_identifiers_val),
       estimated_score_(estimated_score_val),
       duration_(duration_val),
-      readable_info_(std::move(readable_info_val))
+      metrics_(metrics),
+      source_(std::move(source)),
+      room_result_(room_result)
 {
 }
 ICollection<String> *RoomResultImpl::GetCharacterIdentifiers() const noexcept
@@ -76,12 +124,123 @@ String RoomResultImpl::GetIdentifier() const noexcept
 }
 String RoomResultImpl::GetReadableInfo() const noexcept
 {
+    try
+    {
+        std::call_once(readable_info_once_, [this] {
+            readable_info_ = String(room_result_->room->to_string()
+                                        .append("\n")
+                                        .append(room_result_->solution.ToString()).c_str());
+            room_result_ = nullptr;
+            source_.reset();
+        });
+    }
+    catch (const std::exception &e)
+    {
+        LOG_E("Failed to format room result: ", e.what());
+    }
     return readable_info_;
 }
+double RoomResultImpl::GetMetric(const char *name) const noexcept
+{
+    try
+    {
+        return FindMetric(static_cast<Json::Value>(api::JsonOutRoomMetricsStruct{metrics_}), name);
+    }
+    catch (const std::exception &e)
+    {
+        LOG_E("Failed to get metric: ", e.what());
+        return -1;
+    }
+}
 RoomResultImpl::~RoomResultImpl() noexcept
 {
     delete char_identifiers_;
 }
+AsyncResultImpl::AsyncResultImpl(std::shared_ptr<algorithm::CancellationToken> cancel_token,
+                                 std::function<IResult *()> task)
+    : cancel_token_(std::move(cancel_token))
+{
+    auto run = [this, task = std::move(task)]() {
+        try
+        {
+            result_.reset(task());
+        }
+        catch (...)
+        {
+            error_ = std::current_exception();
+        }
+    };
+
+#ifdef ALBC_HAVE_THREADS
+    done_ = std::async(std::launch::async, std::move(run)).share();
+#else
+    // 没有线程支持时在构造时同步求解。延迟执行的future在wait_for中不会被执行，IsReady和Wait将永远不会返回就绪
+    run();
+    std::promise<void> ready;
+    ready.set_value();
+    done_ = ready.get_future().share();
+#endif
+}
+bool AsyncResultImpl::IsReady() const noexcept
+{
+    return done_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+bool AsyncResultImpl::Wait(double timeout_seconds) const noexcept
+{
+    if (timeout_seconds < 0)
+    {
+        done_.wait();
+        return true;
+    }
+    return done_.wait_for(std::chrono::duration<double>(timeout_seconds)) == std::future_status::ready;
+}
+void AsyncResultImpl::Cancel() noexcept
+{
+    cancel_token_->Cancel();
+}
+IResult *AsyncResultImpl::GetResult(AlbcException **e_ptr) noexcept
+{
+    try
+    {
+        done_.wait();
+        if (retrieved_)
+            throw std::logic_error("result has already been retrieved");
+
+        retrieved_ = true;
+        if (error_)
+            std::rethrow_exception(error_);
+
+        return result_.release();
+    }
+    ALBC_API_CATCH_AND_TRANSLATE_EXCEPTION(e_ptr, "calling API")
+    return nullptr;
+}
+AsyncResultImpl::~AsyncResultImpl() noexcept
+{
+    // 后台任务引用了this，必须等待其结束
+    cancel_token_->Cancel();
+    done_.wait();
+}
+int BatchResultImpl::GetStatus() const noexcept
+{
+    return status;
+}
+String BatchResultImpl::GetOutput() const noexcept
+{
+    return String(output.c_str());
+}
+String BatchResultImpl::GetErrorMessage() const noexcept
+{
+    return String(error_message.c_str());
+}
+double BatchResultImpl::GetElapsedSeconds() const noexcept
+{
+    return elapsed_seconds;
+}
+BatchResultCollectionImpl::~BatchResultCollectionImpl()
+{
+    mem::free_ptr_vector(*this);
+}
 void Character::Impl::SetIdentifier(const std::string &identifier)
 {
     if (identifier.empty())
@@ -223,17 +382,29 @@ void Room::Impl::EnsurePrepared() const
         throw std::runtime_error("Room not prepared: " + cached_identifier_);
 }
 Model::Impl::Impl(const Json::Value &player_data_json)
-    : player_data_(mem::make_unique_nothrow<data::player::PlayerDataModel>(player_data_json))
 {
+    player_data_parse_seconds_ = util::MeasureTime([&]() {
+        player_data_ = mem::make_unique_nothrow<data::player::PlayerDataModel>(player_data_json);
+    }).count();
+    create_type_ = ModelCreateType::FROM_JSON;
+}
+Model::Impl::Impl(util::JsonStreamReader &player_data_reader)
+{
+    player_data_parse_seconds_ = util::MeasureTime([&]() {
+        player_data_ = std::make_unique<data::player::PlayerDataModel>(player_data_reader);
+    }).count();
     create_type_ = ModelCreateType::FROM_JSON;
 }
 Model::Impl *Model::Impl::CreateFromFile(const char *player_data_path)
 {
-    return new Impl(util::read_json_from_file(player_data_path));
+    const util::MappedFile file(player_data_path);
+    util::JsonStreamReader reader(file.data(), file.data() + file.size());
+    return new Impl(reader);
 }
 Model::Impl *Model::Impl::CreateFromJson(const char *player_data_json)
 {
-    return new Impl(util::read_json_from_char_array(player_data_json));
+    util::JsonStreamReader reader(player_data_json, player_data_json + std::strlen(player_data_json));
+    return new Impl(reader);
 }
 Model::Impl::Impl()
 {
@@ -275,12 +446,42 @@ void Model::Impl::EnsurePrepared() const
         character->impl()->EnsurePrepared();
     }
 }
-algorithm::iface::AlgorithmParams Model::Impl::CreateAlgParams() const
+void Model::Impl::ForbidCharacter(const std::string &char_identifier)
 {
+    if (char_identifier.empty())
+        throw std::invalid_argument("identifier cannot be empty");
+
+    constraints_.pinned_ops.erase(char_identifier);
+    constraints_.forbidden_ops.insert(char_identifier);
+}
+void Model::Impl::PinCharacter(const std::string &char_identifier, const std::string &room_identifier)
+{
+    if (char_identifier.empty() || room_identifier.empty())
+        throw std::invalid_argument("identifier cannot be empty");
+
+    constraints_.forbidden_ops.erase(char_identifier);
+    constraints_.pinned_ops[char_identifier] = room_identifier;
+}
+void Model::Impl::ClearConstraints()
+{
+    constraints_ = {};
+}
+std::shared_ptr<algorithm::iface::AlgorithmParams> Model::Impl::CreateAlgParams(algorithm::SolveMetrics &metrics) const
+{
+    using algorithm::iface::AlgorithmParams;
+
     if (create_type_ == ModelCreateType::FROM_JSON)
     {
-        return {*player_data_, *building_data_};
+        // 玩家数据只在创建模型时解析一次，每次求解都报告该耗时
+        metrics.resolve_seconds = player_data_parse_seconds_;
+        std::shared_ptr<AlgorithmParams> params;
+        metrics.params_seconds = util::MeasureTime([&]() {
+            params = std::make_shared<AlgorithmParams>(*player_data_, *building_data_);
+        }).count();
+        return params;
     }
+
+    const auto resolve_start = util::PerfClock::now();
     EnsurePrepared();
     algorithm::iface::CustomPackedInput input;
     for (const auto& room : rooms_)
@@ -292,23 +493,72 @@ algorithm::iface::AlgorithmParams Model::Impl::CreateAlgParams() const
     {
         input.characters.push_back(character->impl()->GetCharacterData().value());
     }
+    metrics.resolve_seconds = util::FloatingSeconds(util::PerfClock::now() - resolve_start).count();
 
-    return { input, *building_data_ };
+    std::shared_ptr<AlgorithmParams> params;
+    metrics.params_seconds = util::MeasureTime([&]() {
+        params = std::make_shared<AlgorithmParams>(input, *building_data_);
+    }).count();
+    return params;
 }
 IResult *Model::Impl::GetResult() const
 {
     using namespace algorithm::iface;
     using namespace algorithm;
 
-    AlgorithmParams params = CreateAlgParams();
-    LOG_D("Creating algorithm params: ", params.GetOperators().size(), " operators, ");
+    SolveMetrics prepare_metrics;
+    auto params = CreateAlgParams(prepare_metrics);
+    params->SetConstraints(constraints_);
+    LOG_D("Creating algorithm params: ", params->GetOperators().size(), " operators, ");
     const auto sc = SCOPE_TIMER_WITH_TRACE("Solving");
     const auto i_runner = api::di::Resolve<IRunner>();
+    AlgorithmResult alg_result;
+    {
+        std::lock_guard<std::mutex> lock(session_->mutex);
+        i_runner->Run(*params, GetSolverParameters(), session_->session, alg_result);
+    }
+    alg_result.metrics.resolve_seconds = prepare_metrics.resolve_seconds;
+    alg_result.metrics.params_seconds = prepare_metrics.params_seconds;
+    return CreateResult(std::move(params), std::move(alg_result));
+}
+IAsyncResult *Model::Impl::GetResultAsync() const
+{
+    using namespace algorithm::iface;
+    using namespace algorithm;
+
+    // 参数在调用线程中生成，之后对模型的修改不影响正在进行的求解
+    SolveMetrics prepare_metrics;
+    auto params = CreateAlgParams(prepare_metrics);
+    auto cancel_token = std::make_shared<CancellationToken>();
+    params->SetConstraints(constraints_);
+    params->SetCancellationToken(cancel_token);
+    const auto sp = GetSolverParameters();
+    const auto i_runner = api::di::Resolve<IRunner>();
+    auto session = session_;
+
+    return new AsyncResultImpl(cancel_token, [params, sp, i_runner, session, prepare_metrics]() {
+        const auto sc = SCOPE_TIMER_WITH_TRACE("Solving");
+        AlgorithmResult alg_result;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            i_runner->Run(*params, sp, session->session, alg_result);
+        }
+        alg_result.metrics.resolve_seconds = prepare_metrics.resolve_seconds;
+        alg_result.metrics.params_seconds = prepare_metrics.params_seconds;
+        return CreateResult(params, std::move(alg_result));
+    });
+}
+AlbcSolverParameters Model::Impl::GetSolverParameters() const
+{
+    using namespace algorithm;
+
     AlbcSolverParameters sp;
     sp.gen_lp_file = false;
     sp.gen_all_solution_details = false;
     sp.solve_time_limit = model_parameters[ALBC_MODEL_PARAM_SOLVE_TIME_LIMIT];
     sp.model_time_limit = model_parameters[ALBC_MODEL_PARAM_DURATION];
+    sp.solution_pool_size = static_cast<int>(model_parameters[ALBC_MODEL_PARAM_SOLUTION_POOL_SIZE]);
+    sp.marginal_value_mode = static_cast<AlbcMarginalValueMode>(model_parameters[ALBC_MODEL_PARAM_MARGINAL_VALUE_MODE]);
 
     if (sp.model_time_limit <= 0)
         sp.model_time_limit = kDefaultModelTimeLimit;
@@ -316,11 +566,33 @@ IResult *Model::Impl::GetResult() const
     if (sp.solve_time_limit <= 0)
         sp.solve_time_limit = kDefaultSolveTimeLimit;
 
-    AlgorithmResult alg_result;
-    i_runner->Run(params, sp, alg_result);
+    return sp;
+}
+IResult *Model::Impl::CreateResult(std::shared_ptr<const algorithm::iface::AlgorithmParams> params,
+                                   algorithm::AlgorithmResult &&alg_result)
+{
+    auto output = std::make_shared<SolveOutput>();
+    output->params = std::move(params);
+    output->result.rooms = std::move(alg_result.rooms);
+    output->result.alternatives = std::move(alg_result.alternatives);
+    output->result.metrics = std::move(alg_result.metrics);
+    api::GetGlobalSolveStatistics().Record(output->result.metrics);
+    std::shared_ptr<const SolveOutput> source = std::move(output);
 
-    auto result = new ResultImpl(0, new ICollectionVectorImpl<IRoomResult *>());
-    for (const auto &alg_room_result : alg_result.rooms)
+    auto result = new ResultImpl(0, CreateRoomResults(source, source->result.rooms));
+    result->marginal_values = std::move(alg_result.marginal_values);
+    result->metrics = source->result.metrics;
+    for (const auto &alternative : source->result.alternatives)
+    {
+        result->alternatives->push_back(new ResultImpl(0, CreateRoomResults(source, alternative)));
+    }
+    return result;
+}
+ICollectionVectorImpl<IRoomResult *> *Model::Impl::CreateRoomResults(const std::shared_ptr<const SolveOutput> &source,
+                                                                     const Vector<algorithm::RoomResult> &alg_rooms)
+{
+    auto rooms = new ICollectionVectorImpl<IRoomResult *>();
+    for (const auto &alg_room_result : alg_rooms)
     {
         auto ops = new ICollectionVectorImpl<String>();
         for (const auto* op: alg_room_result.solution.operators)
@@ -330,17 +602,19 @@ IResult *Model::Impl::GetResult() const
                 ops->emplace_back(op->identifier.c_str());
             }
         }
+        const auto &room_metrics = source->result.metrics.rooms;
+        const auto metrics_it = room_metrics.find(alg_room_result.room->id);
         auto* room_result = new RoomResultImpl(
             String(alg_room_result.room->id.c_str()),
             ops,
             alg_room_result.solution.productivity,
             alg_room_result.solution.duration,
-            String(alg_room_result.room->to_string()
-                       .append("\n")
-                       .append(alg_room_result.solution.ToString()).c_str()));
+            source,
+            &alg_room_result,
+            metrics_it != room_metrics.end() ? metrics_it->second : algorithm::RoomSolveMetrics{});
 
-        result->rooms->push_back(room_result);
+        rooms->push_back(room_result);
     }
-    return result;
+    return rooms;
 }
 }
\ No newline at end of file
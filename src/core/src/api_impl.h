@@ -11,6 +11,9 @@
 #include "algorithm.h"
 #include "algorithm_consts.h"
 
+#include <functional>
+#include <future>
+#include <mutex>
 #include <numeric>
 
 namespace albc
@@ -82,21 +85,40 @@ class ResultImpl: public IResult
   public:
     int status;
     ICollectionVectorImpl<IRoomResult*>*rooms;
+    ICollectionVectorImpl<IResult*>*alternatives;
+    Dictionary<std::string, double> marginal_values;
+    algorithm::SolveMetrics metrics;
 
     ResultImpl(int status_val, ICollectionVectorImpl<IRoomResult*>* rooms_val);
 
     [[nodiscard]] int GetStatus() const noexcept override;
     [[nodiscard]] ICollection<IRoomResult *>* GetRoomDetails() const noexcept override;
+    [[nodiscard]] ICollection<IResult *>* GetAlternatives() const noexcept override;
+    [[nodiscard]] double GetMarginalValue(const char *char_identifier) const noexcept override;
+    [[nodiscard]] double GetMetric(const char *name) const noexcept override;
     ~ResultImpl() override;
 };
 
+// 一次求解的原始输出。结果中的房间、干员指针由求解参数持有，生成可读信息前需保持参数存活
+struct SolveOutput
+{
+    std::shared_ptr<const algorithm::iface::AlgorithmParams> params;
+    algorithm::AlgorithmResult result;
+};
+
 class RoomResultImpl: public IRoomResult
 {
     String id_;
     ICollectionVectorImpl<String>* char_identifiers_;
     double estimated_score_;
     double duration_;
-    String readable_info_;
+    algorithm::RoomSolveMetrics metrics_;
+
+    // 可读信息在首次获取时才生成，之后缓存；生成后即释放对求解输出的引用
+    mutable std::shared_ptr<const SolveOutput> source_;
+    mutable const algorithm::RoomResult* room_result_;
+    mutable std::once_flag readable_info_once_;
+    mutable String readable_info_;
 
   public:
     RoomResultImpl(
@@ -104,16 +126,59 @@ class RoomResultImpl: public IRoomResult
         ICollectionVectorImpl<String>* char_identifiers_val,
         double estimated_score_val,
         double duration_val,
-        String readable_info_val);
+        std::shared_ptr<const SolveOutput> source,
+        const algorithm::RoomResult* room_result,
+        const algorithm::RoomSolveMetrics& metrics);
 
     [[nodiscard]] ICollection<String> *GetCharacterIdentifiers() const noexcept override;
     [[nodiscard]] double GetScore() const noexcept override;
     [[nodiscard]] double GetDuration() const noexcept override;
     [[nodiscard]] String GetIdentifier() const noexcept override;
     [[nodiscard]] String GetReadableInfo() const noexcept override;
+    [[nodiscard]] double GetMetric(const char *name) const noexcept override;
     ~RoomResultImpl() noexcept override;
 };
 
+class AsyncResultImpl: public IAsyncResult
+{
+    std::shared_ptr<algorithm::CancellationToken> cancel_token_;
+    mutable std::shared_future<void> done_;
+    std::unique_ptr<IResult> result_;
+    std::exception_ptr error_;
+    bool retrieved_ = false;
+
+  public:
+    // task在后台线程中执行，返回的结果由该对象持有直到被GetResult取走
+    AsyncResultImpl(std::shared_ptr<algorithm::CancellationToken> cancel_token,
+                    std::function<IResult *()> task);
+
+    [[nodiscard]] bool IsReady() const noexcept override;
+    bool Wait(double timeout_seconds) const noexcept override;
+    void Cancel() noexcept override;
+    IResult *GetResult(AlbcException **e_ptr) noexcept override;
+    ~AsyncResultImpl() noexcept override;
+};
+
+class BatchResultImpl: public IBatchResult
+{
+  public:
+    int status = 0;
+    std::string output;
+    std::string error_message;
+    double elapsed_seconds = 0;
+
+    [[nodiscard]] int GetStatus() const noexcept override;
+    [[nodiscard]] String GetOutput() const noexcept override;
+    [[nodiscard]] String GetErrorMessage() const noexcept override;
+    [[nodiscard]] double GetElapsedSeconds() const noexcept override;
+};
+
+// 持有批量求解的各项结果，随集合一同释放
+struct BatchResultCollectionImpl : public ICollectionVectorImpl<IBatchResult *>
+{
+    ~BatchResultCollectionImpl() override;
+};
+
 class Character::Impl
 {
     algorithm::iface::CustomCharacter character_ {api::di::Resolve<data::game::ICharacterResolver>(),
@@ -181,15 +246,27 @@ class Model::Impl
 
     std::shared_ptr<data::building::BuildingData> building_data_ = api::di::Resolve<data::building::BuildingData>();
     std::unique_ptr<data::player::PlayerDataModel> player_data_;
+    double player_data_parse_seconds_ = 0; // 创建模型时流式解析玩家数据的耗时
     Vector<Character*> characters_;
     Vector<Room*> rooms_;
     ModelCreateType create_type_;
+    // 在多次GetResult之间复用未变化房间的组合。求解期间持有mutex，同一模型上的并发求解依次使用session；
+    // 异步求解的任务共享所有权，模型先于句柄释放时会话仍然有效
+    struct SharedSolveSession
+    {
+        std::mutex mutex;
+        algorithm::SolveSession session;
+    };
+    std::shared_ptr<SharedSolveSession> session_ = std::make_shared<SharedSolveSession>();
+    algorithm::OperatorConstraints constraints_;
 
   public:
     Array<double, util::enum_size<AlbcModelParamType>::value> model_parameters{};
 
     explicit Impl(const Json::Value &player_data_json);
 
+    explicit Impl(util::JsonStreamReader &player_data_reader);
+
     static Impl* CreateFromFile(const char *player_data_path);
 
     static Impl* CreateFromJson(const char* player_data_json);
@@ -208,9 +285,28 @@ class Model::Impl
 
     void EnsurePrepared() const;
 
-    [[nodiscard]] algorithm::iface::AlgorithmParams CreateAlgParams() const;
+    void ForbidCharacter(const std::string &char_identifier);
+
+    void PinCharacter(const std::string &char_identifier, const std::string &room_identifier);
+
+    void ClearConstraints();
+
+    // 生成求解参数，并记录解析输入与构造参数的耗时
+    [[nodiscard]] std::shared_ptr<algorithm::iface::AlgorithmParams> CreateAlgParams(
+        algorithm::SolveMetrics &metrics) const;
 
     [[nodiscard]] IResult *GetResult() const;
+
+    [[nodiscard]] IAsyncResult *GetResultAsync() const;
+
+  private:
+    [[nodiscard]] AlbcSolverParameters GetSolverParameters() const;
+
+    [[nodiscard]] static IResult *CreateResult(std::shared_ptr<const algorithm::iface::AlgorithmParams> params,
+                                               algorithm::AlgorithmResult &&alg_result);
+
+    [[nodiscard]] static ICollectionVectorImpl<IRoomResult *> *CreateRoomResults(
+        const std::shared_ptr<const SolveOutput> &source, const Vector<algorithm::RoomResult> &alg_rooms);
 };
 
 }
\ No newline at end of file
@@ -5,14 +5,14 @@
 #include "api_json_io.h"
 namespace albc::api
 {
-Json::Value JsonReader::Read(const char *json) const
+Json::Value JsonReader::Read(std::string_view json) const
 {
     Json::CharReaderBuilder builder;
     builder.settings_["collectComments"] = false;
     std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
     Json::Value root;
     std::string errs;
-    bool ok = reader->parse(json, json + strlen(json), &root, &errs);
+    bool ok = reader->parse(json.data(), json.data() + json.size(), &root, &errs);
     if (!ok)
     {
         throw std::runtime_error(errs);
@@ -22,11 +22,63 @@ Json::Value JsonReader::Read(const char *json) const
 std::string JsonWriter::Write(const Json::Value &json) const
 {
     std::ostringstream oss;
+    Write(json, oss);
+    return oss.str();
+}
+void JsonWriter::Write(const Json::Value &json, std::ostream &os) const
+{
     Json::StreamWriterBuilder builder;
     builder.settings_["emitUTF8"] = true;
 
     std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
-    writer->write(json, &oss);
-    return oss.str();
+    writer->write(json, &os);
+}
+CallbackStreamBuf::CallbackStreamBuf(AlbcWriteHandler handler, void *user_data)
+    : handler_(handler), user_data_(user_data)
+{
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+}
+bool CallbackStreamBuf::Emit(const char *data, size_t size)
+{
+    if (failed_)
+        return false;
+    if (size > 0 && !handler_(data, size, user_data_))
+        failed_ = true;
+    return !failed_;
+}
+bool CallbackStreamBuf::FlushBuffer()
+{
+    const bool ok = Emit(pbase(), static_cast<size_t>(pptr() - pbase()));
+    setp(buffer_.data(), buffer_.data() + buffer_.size());
+    return ok;
+}
+CallbackStreamBuf::int_type CallbackStreamBuf::overflow(int_type ch)
+{
+    if (!FlushBuffer())
+        return traits_type::eof();
+    if (traits_type::eq_int_type(ch, traits_type::eof()))
+        return traits_type::not_eof(ch);
+
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+    return ch;
+}
+std::streamsize CallbackStreamBuf::xsputn(const char *s, std::streamsize n)
+{
+    // 放不进缓冲区的大块数据直接交给回调，避免再复制一次
+    if (n > epptr() - pptr())
+    {
+        if (!FlushBuffer() || !Emit(s, static_cast<size_t>(n)))
+            return 0;
+        return n;
+    }
+
+    traits_type::copy(pptr(), s, static_cast<size_t>(n));
+    pbump(static_cast<int>(n));
+    return n;
+}
+int CallbackStreamBuf::sync()
+{
+    return FlushBuffer() ? 0 : -1;
 }
 } // namespace albc::api
\ No newline at end of file
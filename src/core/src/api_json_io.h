@@ -2,33 +2,64 @@
 // Created by Nonary on 2022/4/24.
 //
 #pragma once
+#include "albc/albc_common.h"
 #include "albc_types.h"
 #include "util_json.h"
 
+#include <array>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+
 namespace albc::api
 {
 
 class IJsonReader
 {
   public:
-    [[nodiscard]] virtual Json::Value Read(const char *json) const = 0;
+    [[nodiscard]] virtual Json::Value Read(std::string_view json) const = 0;
 };
 
 class IJsonWriter
 {
   public:
     [[nodiscard]] virtual std::string Write(const Json::Value &root) const = 0;
+    virtual void Write(const Json::Value &root, std::ostream &os) const = 0;
 };
 
 class JsonReader : public IJsonReader
 {
   public:
-    [[nodiscard]] Json::Value Read(const char *json) const override;
+    [[nodiscard]] Json::Value Read(std::string_view json) const override;
 };
 
 class JsonWriter : public IJsonWriter
 {
   public:
     [[nodiscard]] std::string Write(const Json::Value &root) const override;
+    void Write(const Json::Value &root, std::ostream &os) const override;
+};
+
+// 将写入的数据分块交给AlbcWriteHandler的流缓冲区。回调返回false后流进入错误状态，之后的写入被丢弃
+class CallbackStreamBuf : public std::streambuf
+{
+  public:
+    CallbackStreamBuf(AlbcWriteHandler handler, void *user_data);
+    CallbackStreamBuf(const CallbackStreamBuf &) = delete;
+    CallbackStreamBuf &operator=(const CallbackStreamBuf &) = delete;
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+  private:
+    AlbcWriteHandler handler_;
+    void *user_data_;
+    bool failed_ = false;
+    std::array<char, 4096> buffer_ {};
+
+    bool Emit(const char *data, size_t size);
+    bool FlushBuffer();
 };
 } // namespace albc::api
\ No newline at end of file
@@ -64,12 +64,29 @@ JsonInParams::JsonInParams(const Json::Value &val)
       solve_time_limit(val.get(kSolveTimeLimit, algorithm::kDefaultSolveTimeLimit).asInt()),
       gen_sol_details(val.get(kGenSolDetails, false).asBool()),
       gen_lp_file(val.get(kGenLpFile, false).asBool()),
+      solution_pool_size(val.get(kSolutionPoolSize, 1).asInt()),
+      forbidden_chars(util::json_val_as_vector<std::string>(
+          val.get(kForbiddenChars, Json::Value(Json::arrayValue)),
+          util::json_cast<std::string>)),
+      pinned_chars(util::json_val_as_dictionary<std::string>(
+          val.get(kPinnedChars, Json::Value(Json::objectValue)),
+          util::json_cast<std::string>)),
+      marginal_value_mode(static_cast<AlbcMarginalValueMode>(
+          util::parse_enum_string(val.get(kMarginalValueMode, "NONE").asString(), JsonMarginalValueMode::NONE))),
       chars(util::json_val_as_dictionary<JsonInCharStruct>(
           val.get(kChars, Json::Value(Json::objectValue)))),
       rooms(util::json_val_as_dictionary<JsonInRoomStruct>(
           val.get(kRooms, Json::Value(Json::objectValue))))
 {
 }
+JsonOutRoomStruct::JsonOutRoomStruct(const Json::Value &val)
+    : score(val.get(kScore, 0).asDouble()),
+      duration(val.get(kDuration, 0).asDouble()),
+      chars(util::json_val_as_vector<std::string>(
+          val.get(kChars, Json::Value(Json::arrayValue)),
+          util::json_cast<std::string>))
+{
+}
 JsonOutRoomStruct::operator Json::Value() const
 {
     Json::Value val;
@@ -78,11 +95,113 @@ JsonOutRoomStruct::operator Json::Value() const
     val[kChars] = util::json_val_from_vector<std::string>(chars);
     return val;
 }
+JsonOutParams::JsonOutParams(const Json::Value &val)
+    : rooms(util::json_val_as_dictionary<JsonOutRoomStruct>(
+          val.get(kRooms, Json::Value(Json::objectValue)))),
+      marginal_values(util::json_val_as_dictionary<double>(
+          val.get(kMarginalValues, Json::Value(Json::objectValue)),
+          util::json_cast<double>))
+{
+    for (const auto &alternative_val : val.get(kAlternatives, Json::Value(Json::arrayValue)))
+    {
+        alternatives.push_back(util::json_val_as_dictionary<JsonOutRoomStruct>(
+            alternative_val.get(kRooms, Json::Value(Json::objectValue))));
+    }
+}
 JsonOutParams::operator Json::Value() const
 {
     Json::Value val;
     val[kRooms] = util::json_val_from_dictionary<JsonOutRoomStruct>(rooms, util::to_json_cast<JsonOutRoomStruct>);
     val[kErrors] = static_cast<Json::Value>(errors);
+    if (!alternatives.empty())
+    {
+        Json::Value alternatives_val(Json::arrayValue);
+        for (const auto &alternative : alternatives)
+        {
+            Json::Value alternative_val;
+            alternative_val[kRooms] = util::json_val_from_dictionary<JsonOutRoomStruct>(alternative, util::to_json_cast<JsonOutRoomStruct>);
+            alternatives_val.append(std::move(alternative_val));
+        }
+        val[kAlternatives] = std::move(alternatives_val);
+    }
+    if (!marginal_values.empty())
+    {
+        val[kMarginalValues] = util::json_val_from_dictionary<double>(marginal_values);
+    }
+    val[kMetrics] = static_cast<Json::Value>(metrics);
+    return val;
+}
+JsonOutRoomMetricsStruct::operator Json::Value() const
+{
+    Json::Value val;
+    val[kFilterSeconds] = metrics.filter_seconds;
+    val[kCombSeconds] = metrics.comb_seconds;
+    val[kInboundChars] = metrics.inbound_ops;
+    val[kCalcCount] = static_cast<Json::UInt64>(metrics.calc_cnt);
+    val[kColumns] = metrics.col_cnt;
+    val[kCached] = metrics.cached;
+    return val;
+}
+JsonOutMetricsStruct::operator Json::Value() const
+{
+    Json::Value val;
+    val[kCacheHit] = cache_hit;
+    val[kResolveSeconds] = metrics.resolve_seconds;
+    val[kParamsSeconds] = metrics.params_seconds;
+    val[kCombSeconds] = metrics.comb_seconds;
+    val[kMatrixSeconds] = metrics.matrix_seconds;
+    val[kCbcSeconds] = metrics.cbc_seconds;
+    val[kAlternativesSeconds] = metrics.alternatives_seconds;
+    val[kMarginalValuesSeconds] = metrics.marginal_values_seconds;
+    val[kCalcCount] = static_cast<Json::UInt64>(metrics.calc_cnt);
+    val[kColumns] = metrics.col_cnt;
+    val[kRows] = metrics.row_cnt;
+    val[kNonzeros] = metrics.nonzero_cnt;
+    val[kNodes] = static_cast<Json::Int64>(metrics.nodes);
+    val[kGap] = metrics.gap;
+    val[kArenaAllocations] = static_cast<Json::UInt64>(metrics.arena_allocations);
+    val[kArenaBlocks] = static_cast<Json::UInt64>(metrics.arena_blocks);
+    val[kArenaBytes] = static_cast<Json::UInt64>(metrics.arena_bytes);
+    val[kEstimatedColumns] = static_cast<Json::UInt64>(metrics.estimated_col_cnt);
+    val[kEstimatedMemoryBytes] = static_cast<Json::UInt64>(metrics.estimated_memory_bytes);
+    val[kGreedy] = metrics.greedy;
+
+    Json::Value rooms_val(Json::objectValue);
+    for (const auto &[room_id, room_metrics] : metrics.rooms)
+        rooms_val[room_id] = static_cast<Json::Value>(JsonOutRoomMetricsStruct{room_metrics});
+    val[kRooms] = std::move(rooms_val);
+    return val;
+}
+JsonOutRoomEstimateStruct::operator Json::Value() const
+{
+    Json::Value val;
+    val[kInboundChars] = estimate.inbound_ops;
+    val[kCombSize] = estimate.comb_size;
+    val[kMutexGroups] = estimate.mutex_groups;
+    val[kCombCount] = static_cast<Json::UInt64>(estimate.base_comb_cnt);
+    val[kMutexCombCount] = static_cast<Json::UInt64>(estimate.mutex_comb_cnt);
+    val[kPartialCombCount] = static_cast<Json::UInt64>(estimate.partial_comb_cnt);
+    val[kColumns] = static_cast<Json::UInt64>(estimate.col_cnt);
+    val[kSolutionBytes] = static_cast<Json::UInt64>(estimate.solution_bytes);
+    val[kMatrixBytes] = static_cast<Json::UInt64>(estimate.matrix_bytes);
+    return val;
+}
+JsonOutEstimateStruct::operator Json::Value() const
+{
+    Json::Value val;
+    val[kErrors] = static_cast<Json::Value>(errors);
+    val[kGreedy] = greedy;
+    val[kMarginalValueMode] =
+        std::string(util::enum_to_string(static_cast<JsonMarginalValueMode>(marginal_value_mode)));
+    val[kColumns] = static_cast<Json::UInt64>(estimate.col_cnt);
+    val[kMemoryBytes] = static_cast<Json::UInt64>(estimate.MemoryBytes());
+    val[kSolutionBytes] = static_cast<Json::UInt64>(estimate.solution_bytes);
+    val[kMatrixBytes] = static_cast<Json::UInt64>(estimate.matrix_bytes);
+
+    Json::Value rooms_val(Json::objectValue);
+    for (const auto &[room_id, room_estimate] : estimate.rooms)
+        rooms_val[room_id] = static_cast<Json::Value>(JsonOutRoomEstimateStruct{room_estimate});
+    val[kRooms] = std::move(rooms_val);
     return val;
 }
 JsonOutErrorStruct::operator Json::Value() const
@@ -1,4 +1,6 @@
 #pragma once
+#include "albc/albc_common.h"
+#include "algorithm_params.h"
 #include "util_json.h"
 #include "data_building.h"
 #include "model_buff_primitives.h"
@@ -44,6 +46,13 @@ enum class JsonTradingOrderType
     SHARD = (int)model::buff::OrderType::ORUNDUM,
 };
 
+enum class JsonMarginalValueMode
+{
+    NONE = ALBC_MARGINAL_VALUE_NONE,
+    DUAL = ALBC_MARGINAL_VALUE_DUAL,
+    LEAVE_ONE_OUT = ALBC_MARGINAL_VALUE_LEAVE_ONE_OUT,
+};
+
 struct JsonInCharStruct
 {
     std::string name;           ALBC_API_JSON_KEY(kName,    "name");
@@ -90,6 +99,10 @@ struct JsonInParams
     int solve_time_limit;                                 ALBC_API_JSON_KEY(kSolveTimeLimit, "solveTimeLimit");
     bool gen_sol_details;                                 ALBC_API_JSON_KEY(kGenSolDetails, "genSolDetails");
     bool gen_lp_file;                                     ALBC_API_JSON_KEY(kGenLpFile, "genLpFile");
+    int solution_pool_size;                               ALBC_API_JSON_KEY(kSolutionPoolSize, "solutionPoolSize");
+    Vector<std::string> forbidden_chars;                  ALBC_API_JSON_KEY(kForbiddenChars, "forbiddenChars");
+    Dictionary<std::string, std::string> pinned_chars;    ALBC_API_JSON_KEY(kPinnedChars, "pinnedChars"); // 干员标识符 -> 房间标识符
+    AlbcMarginalValueMode marginal_value_mode;            ALBC_API_JSON_KEY(kMarginalValueMode, "marginalValueMode");
     Dictionary<std::string, JsonInCharStruct> chars;      ALBC_API_JSON_KEY(kChars, "chars");
     Dictionary<std::string, JsonInRoomStruct> rooms;      ALBC_API_JSON_KEY(kRooms, "rooms");
 
@@ -103,6 +116,7 @@ struct JsonOutRoomStruct
     Vector<std::string> chars;                           ALBC_API_JSON_KEY(kChars, "chars");
 
     JsonOutRoomStruct() = default;
+    explicit JsonOutRoomStruct(const Json::Value& val);
     explicit operator Json::Value() const;
 };
 
@@ -116,12 +130,94 @@ struct JsonOutErrorStruct
     explicit operator Json::Value() const;
 };
 
+struct JsonOutRoomMetricsStruct
+{
+    algorithm::RoomSolveMetrics metrics;
+    ALBC_API_JSON_KEY(kFilterSeconds, "filterSeconds");
+    ALBC_API_JSON_KEY(kCombSeconds, "combSeconds");
+    ALBC_API_JSON_KEY(kInboundChars, "inboundChars");
+    ALBC_API_JSON_KEY(kCalcCount, "calcCount");
+    ALBC_API_JSON_KEY(kColumns, "columns");
+    ALBC_API_JSON_KEY(kCached, "cached");
+
+    explicit operator Json::Value() const;
+};
+
+// 各阶段耗时（秒）与模型规模。命中结果缓存时只有解析输入的耗时
+struct JsonOutMetricsStruct
+{
+    algorithm::SolveMetrics metrics;
+    bool cache_hit = false;                              ALBC_API_JSON_KEY(kCacheHit, "cacheHit");
+    ALBC_API_JSON_KEY(kResolveSeconds, "resolveSeconds");
+    ALBC_API_JSON_KEY(kParamsSeconds, "paramsSeconds");
+    ALBC_API_JSON_KEY(kCombSeconds, "combSeconds");
+    ALBC_API_JSON_KEY(kMatrixSeconds, "matrixSeconds");
+    ALBC_API_JSON_KEY(kCbcSeconds, "cbcSeconds");
+    ALBC_API_JSON_KEY(kAlternativesSeconds, "alternativesSeconds");
+    ALBC_API_JSON_KEY(kMarginalValuesSeconds, "marginalValuesSeconds");
+    ALBC_API_JSON_KEY(kCalcCount, "calcCount");
+    ALBC_API_JSON_KEY(kColumns, "columns");
+    ALBC_API_JSON_KEY(kRows, "rows");
+    ALBC_API_JSON_KEY(kNonzeros, "nonzeros");
+    ALBC_API_JSON_KEY(kNodes, "nodes");
+    ALBC_API_JSON_KEY(kGap, "gap");
+    ALBC_API_JSON_KEY(kArenaAllocations, "arenaAllocations");
+    ALBC_API_JSON_KEY(kArenaBlocks, "arenaBlocks");
+    ALBC_API_JSON_KEY(kArenaBytes, "arenaBytes");
+    ALBC_API_JSON_KEY(kEstimatedColumns, "estimatedColumns");
+    ALBC_API_JSON_KEY(kEstimatedMemoryBytes, "estimatedMemoryBytes");
+    ALBC_API_JSON_KEY(kGreedy, "greedy");
+    ALBC_API_JSON_KEY(kRooms, "rooms");
+
+    explicit operator Json::Value() const;
+};
+
+struct JsonOutRoomEstimateStruct
+{
+    algorithm::RoomCombEstimate estimate;
+    ALBC_API_JSON_KEY(kInboundChars, "inboundChars");
+    ALBC_API_JSON_KEY(kCombSize, "combSize");
+    ALBC_API_JSON_KEY(kMutexGroups, "mutexGroups");
+    ALBC_API_JSON_KEY(kCombCount, "combCount");
+    ALBC_API_JSON_KEY(kMutexCombCount, "mutexCombCount");
+    ALBC_API_JSON_KEY(kPartialCombCount, "partialCombCount");
+    ALBC_API_JSON_KEY(kColumns, "columns");
+    ALBC_API_JSON_KEY(kSolutionBytes, "solutionBytes");
+    ALBC_API_JSON_KEY(kMatrixBytes, "matrixBytes");
+
+    explicit operator Json::Value() const;
+};
+
+// EstimateWithJsonParams的输出：各房间的组合数（列数）与内存估计，以及求解时将采用的策略
+struct JsonOutEstimateStruct
+{
+    JsonOutErrorStruct errors;                           ALBC_API_JSON_KEY(kErrors, "errors");
+    algorithm::CombEstimate estimate;
+    bool greedy = false;                                 ALBC_API_JSON_KEY(kGreedy, "greedy");
+    AlbcMarginalValueMode marginal_value_mode = ALBC_MARGINAL_VALUE_NONE;
+    ALBC_API_JSON_KEY(kMarginalValueMode, "marginalValueMode");
+    ALBC_API_JSON_KEY(kColumns, "columns");
+    ALBC_API_JSON_KEY(kMemoryBytes, "memoryBytes");
+    ALBC_API_JSON_KEY(kSolutionBytes, "solutionBytes");
+    ALBC_API_JSON_KEY(kMatrixBytes, "matrixBytes");
+    ALBC_API_JSON_KEY(kRooms, "rooms");
+
+    explicit operator Json::Value() const;
+};
+
 struct JsonOutParams
 {
     Dictionary<std::string, JsonOutRoomStruct> rooms;    ALBC_API_JSON_KEY(kRooms, "rooms");
     JsonOutErrorStruct errors;                           ALBC_API_JSON_KEY(kErrors, "errors");
+    // 备选方案，按总产能降序排列，为空时不输出
+    Vector<Dictionary<std::string, JsonOutRoomStruct>> alternatives; ALBC_API_JSON_KEY(kAlternatives, "alternatives");
+    // 干员边际价值，为空时不输出
+    Dictionary<std::string, double> marginal_values;     ALBC_API_JSON_KEY(kMarginalValues, "marginalValues");
+    JsonOutMetricsStruct metrics;                        ALBC_API_JSON_KEY(kMetrics, "metrics");
 
     JsonOutParams() = default;
+    // 从输出的Json还原结果（用于结果缓存），错误信息与统计不会被还原
+    explicit JsonOutParams(const Json::Value& val);
     explicit operator Json::Value() const;
 };
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "util_json.h"
 
 #include <atomic>
+#include <memory>
 
 namespace albc::api
 {
@@ -32,34 +33,44 @@ class ResourceStorage
         return version_;
     }
 
-    constexpr void Add(TIndex index, std::shared_ptr<TStore> store)
+    // 各存储槽位均以原子方式读写，允许在其他线程读取的同时重新加载数据
+    void Add(TIndex index, std::shared_ptr<TStore> store)
     {
-        (*this)[index] = store;
+        std::atomic_store(&(*this)[index], std::move(store));
     }
 
     template <typename... Args,
         std::enable_if_t<std::is_constructible_v<TStore, Args...>, bool> = true>
-    constexpr void Store(TIndex index, Args&&... args)
+    void Store(TIndex index, Args&&... args)
     {
+        // 先替换数据再更新版本号，读取到新版本号的一方总能看到新数据
+        std::atomic_store(&(*this)[index], std::make_shared<TStore>(std::forward<Args>(args)...));
+        version_++;
+    }
+
+    // 替换存储槽位并更新版本号，顺序同Store
+    void Replace(TIndex index, std::shared_ptr<TStore> store)
+    {
+        std::atomic_store(&(*this)[index], std::move(store));
         version_++;
-        (*this)[index] = std::make_shared<TStore>(std::forward<Args>(args)...);
     }
 
     std::shared_ptr<TStore> Get(TIndex index) const
     {
-        return (*this)[index];
+        return std::atomic_load(&(*this)[index]);
     }
 
-    constexpr bool Has(TIndex index) const
+    bool Has(TIndex index) const
     {
-        return (*this)[index] != nullptr;
+        return Get(index) != nullptr;
     }
 
     template <typename TGet,
               std::enable_if_t<std::is_constructible_v<TGet, TStore>, bool> = true>
     std::shared_ptr<TGet> Resolve(TIndex index) const
     {
-        if (!Has(index))
+        const auto store = Get(index);
+        if (!store)
         {
             throw std::runtime_error(
                 std::string("Resource of type: ")
@@ -70,7 +81,7 @@ class ResourceStorage
 
         try
         {
-            return std::make_shared<TGet>(*Get(index));
+            return std::make_shared<TGet>(*store);
         }
         catch(const std::exception& e)
         {
@@ -79,13 +90,13 @@ class ResourceStorage
         }
     }
 
-    constexpr void Clear()
+    void Clear()
     {
-        version_++;
         for (auto &item : storage_)
         {
-            item.reset();
+            std::atomic_store(&item, std::shared_ptr<TStore>());
         }
+        version_++;
     }
 };
 
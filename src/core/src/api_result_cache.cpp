@@ -0,0 +1,345 @@
+#include "api_result_cache.h"
+#include "api_json_io.h"
+#include "util.h"
+#include "util_log.h"
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+
+#ifdef _WIN32
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <unistd.h>
+#endif
+
+namespace albc::api
+{
+namespace
+{
+// 键材料的格式版本，格式变化时递增，使旧的磁盘缓存失效
+constexpr int kKeyMaterialVersion = 1;
+
+constexpr const char *kDiskKeyMaterialKey = "key";
+constexpr const char *kDiskResultKey = "result";
+
+// 进程、线程与进程内序号共同组成临时文件名，共享缓存目录的多个进程及同一线程的多次写入互不干扰
+std::string MakeTempFileSuffix()
+{
+    static std::atomic<UInt64> counter{0};
+#ifdef _WIN32
+    const auto pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    const auto pid = static_cast<unsigned long>(getpid());
+#endif
+    char suffix[80];
+    std::snprintf(suffix, sizeof suffix, ".%lx.%zx.%llx.tmp", pid,
+                  std::hash<std::thread::id>{}(std::this_thread::get_id()),
+                  static_cast<unsigned long long>(counter.fetch_add(1, std::memory_order_relaxed)));
+    return suffix;
+}
+
+// 用临时文件替换目标文件。std::rename在Windows上目标已存在时失败
+bool MoveTempFileOver(const std::string &from, const std::string &to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+// 将字段逐个编码为文本，字符串带长度前缀，浮点数保留全部有效数字，编码结果与平台及进程无关
+class KeyMaterialWriter
+{
+  public:
+    void Put(const std::string &str)
+    {
+        Put(static_cast<UInt64>(str.size()));
+        material_.append(str).push_back(';');
+    }
+
+    void Put(double value)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof buf, "%.17g;", value);
+        material_.append(buf);
+    }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>, bool> = true>
+    void Put(T value)
+    {
+        material_.append(std::to_string(static_cast<Int64>(value))).push_back(';');
+    }
+
+    [[nodiscard]] std::string Take()
+    {
+        return std::move(material_);
+    }
+
+  private:
+    std::string material_;
+};
+} // namespace
+
+std::string ResultCache::MakeKeyMaterial(const algorithm::iface::CustomPackedInput &input,
+                                         const AlbcSolverParameters &solver_params,
+                                         const algorithm::OperatorConstraints &constraints,
+                                         UInt64 game_data_digest)
+{
+    KeyMaterialWriter w;
+    w.Put(kKeyMaterialVersion);
+    w.Put(std::to_string(game_data_digest));
+    w.Put(solver_params.solve_time_limit);
+    w.Put(solver_params.model_time_limit);
+    w.Put(solver_params.solution_pool_size);
+    w.Put(solver_params.marginal_value_mode);
+
+    w.Put(input.characters.size());
+    for (const auto &character : input.characters)
+    {
+        w.Put(character.identifier);
+        w.Put(character.resolved_char_id);
+        w.Put(character.sp_char_group);
+        w.Put(character.is_regular_character);
+        w.Put(character.morale);
+        w.Put(character.phase);
+        w.Put(character.level);
+        w.Put(character.resolved_skill_ids.size());
+        for (const auto &skill_id : character.resolved_skill_ids)
+            w.Put(skill_id);
+    }
+
+    w.Put(input.rooms.size());
+    for (const auto &room : input.rooms)
+    {
+        w.Put(room.identifier);
+        w.Put(room.type);
+        w.Put(room.max_slot_cnt);
+        w.Put(room.level);
+        w.Put(room.room_attributes.prod_type);
+        w.Put(room.room_attributes.order_type);
+        w.Put(room.room_attributes.base_prod_eff);
+        w.Put(room.room_attributes.base_prod_cap);
+        w.Put(room.room_attributes.base_char_cost);
+        w.Put(room.room_attributes.prod_cnt);
+    }
+
+    // 约束为有序容器，遍历顺序确定
+    w.Put(constraints.forbidden_ops.size());
+    for (const auto &op : constraints.forbidden_ops)
+        w.Put(op);
+
+    w.Put(constraints.pinned_ops.size());
+    for (const auto &[op, room] : constraints.pinned_ops)
+    {
+        w.Put(op);
+        w.Put(room);
+    }
+    return w.Take();
+}
+
+ResultCache::Key ResultCache::MakeKey(const std::string &key_material)
+{
+    return util::fnv1a64(key_material);
+}
+
+bool ResultCache::IsCacheable(const AlbcSolverParameters &solver_params)
+{
+    return !solver_params.gen_lp_file && !solver_params.gen_all_solution_details;
+}
+
+// 锁只保护LRU及计数，磁盘读写与Json转换在锁外进行，不阻塞其他线程的内存查找
+bool ResultCache::TryGet(const std::string &key_material, JsonOutParams &out_params)
+{
+    const Key key = MakeKey(key_material);
+    std::string disk_store_path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ == 0)
+            return false;
+
+        if (const auto it = index_.find(key); it != index_.end() && it->second->key_material == key_material)
+        {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            out_params = it->second->params;
+            ++hit_cnt_;
+            return true;
+        }
+        disk_store_path = disk_store_path_;
+    }
+
+    JsonOutParams params;
+    const bool loaded = TryLoadFromDisk(disk_store_path, key, key_material, params);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!loaded)
+    {
+        ++miss_cnt_;
+        return false;
+    }
+
+    out_params = params;
+    if (capacity_ != 0)
+        PutUnlocked(key, key_material, std::move(params));
+    ++hit_cnt_;
+    return true;
+}
+
+void ResultCache::Put(const std::string &key_material, const JsonOutParams &params)
+{
+    const Key key = MakeKey(key_material);
+    JsonOutParams stored = params;
+    stored.errors = {};
+
+    std::string disk_store_path;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (capacity_ == 0)
+            return;
+
+        PutUnlocked(key, key_material, stored);
+        disk_store_path = disk_store_path_;
+    }
+    SaveToDisk(disk_store_path, key, key_material, stored);
+}
+
+void ResultCache::PutUnlocked(Key key, const std::string &key_material, JsonOutParams params)
+{
+    // 键冲突时新条目覆盖旧条目
+    if (const auto it = index_.find(key); it != index_.end())
+    {
+        it->second->key_material = key_material;
+        it->second->params = std::move(params);
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return;
+    }
+
+    lru_.push_front({key, key_material, std::move(params)});
+    index_[key] = lru_.begin();
+    while (lru_.size() > capacity_)
+    {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+void ResultCache::SetCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    while (lru_.size() > capacity_)
+    {
+        index_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+void ResultCache::SetDiskStorePath(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    disk_store_path_ = path;
+}
+
+size_t ResultCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lru_.size();
+}
+
+size_t ResultCache::GetCapacity() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+UInt64 ResultCache::GetHitCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hit_cnt_;
+}
+
+UInt64 ResultCache::GetMissCount() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return miss_cnt_;
+}
+
+void ResultCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+}
+
+std::string ResultCache::GetDiskStoreFilePath(const std::string &disk_store_path, Key key)
+{
+    char buf[32];
+    std::snprintf(buf, sizeof buf, "%016llx.json", static_cast<unsigned long long>(key));
+    std::string path = disk_store_path;
+    if (!path.empty() && path.back() != '/' && path.back() != '\\')
+        path.push_back('/');
+    return path.append(buf);
+}
+
+bool ResultCache::TryLoadFromDisk(const std::string &disk_store_path, Key key, const std::string &key_material,
+                                  JsonOutParams &out_params)
+{
+    if (disk_store_path.empty())
+        return false;
+
+    const auto path = GetDiskStoreFilePath(disk_store_path, key);
+    if (!std::ifstream(path).is_open())
+        return false;
+
+    try
+    {
+        // 文件中保存了键材料，与本次的键材料不一致时视为未命中（哈希冲突或旧格式的缓存文件）
+        const auto json = util::read_json_from_file(path);
+        if (!json.isObject() || json[kDiskKeyMaterialKey].asString() != key_material)
+            return false;
+
+        out_params = JsonOutParams(json[kDiskResultKey]);
+        return true;
+    }
+    catch (const std::exception &e)
+    {
+        LOG_W("Ignoring corrupted result cache file: ", path, ": ", e.what());
+        return false;
+    }
+}
+
+void ResultCache::SaveToDisk(const std::string &disk_store_path, Key key, const std::string &key_material,
+                             const JsonOutParams &params)
+{
+    if (disk_store_path.empty())
+        return;
+
+    // 先写入临时文件再重命名，避免其他进程读到不完整的文件
+    const auto path = GetDiskStoreFilePath(disk_store_path, key);
+    const auto tmp_path = path + MakeTempFileSuffix();
+    {
+        std::ofstream fs(tmp_path, std::ios::trunc);
+        if (!fs.is_open())
+        {
+            LOG_W("Unable to write result cache file: ", tmp_path);
+            return;
+        }
+        Json::Value json;
+        json[kDiskKeyMaterialKey] = key_material;
+        json[kDiskResultKey] = static_cast<Json::Value>(params);
+        fs << JsonWriter().Write(json);
+    }
+
+    if (!MoveTempFileOver(tmp_path, path))
+    {
+        LOG_W("Unable to write result cache file: ", path);
+        std::remove(tmp_path.c_str());
+    }
+}
+} // namespace albc::api
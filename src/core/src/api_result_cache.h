@@ -0,0 +1,84 @@
+#pragma once
+#include "albc/albc_common.h"
+#include "albc_types.h"
+#include "algorithm_iface_custom.h"
+#include "algorithm_params.h"
+#include "api_json_params.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace albc::api
+{
+/**
+ * @brief RunWithJsonParams的结果缓存
+ *
+ * 将解析后的输入（CustomPackedInput）、求解参数、干员约束及游戏数据内容摘要编码为规范的键材料，
+ * 以其FNV-1a哈希为键，缓存求解得到的JsonOutParams（不含错误信息，错误信息每次由输入重新生成）。
+ * 每个条目同时保存键材料，命中时逐字节比较以排除哈希冲突。
+ * 内存中为LRU缓存，可选地以目录形式持久化到磁盘，内存未命中时再查找磁盘。
+ */
+class ResultCache
+{
+  public:
+    using Key = UInt64;
+    static constexpr size_t kDefaultCapacity = 64;
+
+    [[nodiscard]] static std::string MakeKeyMaterial(const algorithm::iface::CustomPackedInput &input,
+                                                     const AlbcSolverParameters &solver_params,
+                                                     const algorithm::OperatorConstraints &constraints,
+                                                     UInt64 game_data_digest);
+
+    [[nodiscard]] static Key MakeKey(const std::string &key_material);
+
+    // 生成LP文件或组合详情的请求有副作用，不使用缓存
+    [[nodiscard]] static bool IsCacheable(const AlbcSolverParameters &solver_params);
+
+    bool TryGet(const std::string &key_material, JsonOutParams &out_params);
+
+    void Put(const std::string &key_material, const JsonOutParams &params);
+
+    // 设置内存缓存容量，为0时禁用缓存
+    void SetCapacity(size_t capacity);
+
+    // 设置磁盘缓存目录，为空时禁用磁盘缓存
+    void SetDiskStorePath(const std::string &path);
+
+    [[nodiscard]] size_t GetSize() const;
+    [[nodiscard]] size_t GetCapacity() const;
+    [[nodiscard]] UInt64 GetHitCount() const;
+    [[nodiscard]] UInt64 GetMissCount() const;
+
+    void Clear();
+
+  private:
+    struct Entry
+    {
+        Key key;
+        std::string key_material;
+        JsonOutParams params;
+    };
+
+    mutable std::mutex mutex_;
+    size_t capacity_ = kDefaultCapacity;
+    List<Entry> lru_; // 最近使用的在前
+    std::unordered_map<Key, List<Entry>::iterator> index_;
+    std::string disk_store_path_;
+    UInt64 hit_cnt_ = 0;
+    UInt64 miss_cnt_ = 0;
+
+    void PutUnlocked(Key key, const std::string &key_material, JsonOutParams params);
+    // 磁盘读写不访问成员，调用方在锁内复制目录后于锁外调用
+    [[nodiscard]] static std::string GetDiskStoreFilePath(const std::string &disk_store_path, Key key);
+    static bool TryLoadFromDisk(const std::string &disk_store_path, Key key, const std::string &key_material,
+                                JsonOutParams &out_params);
+    static void SaveToDisk(const std::string &disk_store_path, Key key, const std::string &key_material,
+                           const JsonOutParams &params);
+};
+
+inline ResultCache &GetGlobalResultCache()
+{
+    static ResultCache api_global_result_cache;
+    return api_global_result_cache;
+}
+} // namespace albc::api
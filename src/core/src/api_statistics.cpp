@@ -0,0 +1,69 @@
+#include "api_statistics.h"
+
+#include <algorithm>
+
+namespace albc::api
+{
+namespace
+{
+void AddSeconds(std::atomic<UInt64> &counter, double seconds) noexcept
+{
+    if (seconds > 0)
+        counter.fetch_add(static_cast<UInt64>(seconds * 1e6), std::memory_order_relaxed);
+}
+
+void Add(std::atomic<UInt64> &counter, UInt64 value) noexcept
+{
+    counter.fetch_add(value, std::memory_order_relaxed);
+}
+} // namespace
+
+void SolveStatistics::Record(const algorithm::SolveMetrics &metrics) noexcept
+{
+    Add(solve_cnt_, 1);
+    Add(greedy_solve_cnt_, metrics.greedy ? 1 : 0);
+    Add(room_cnt_, metrics.rooms.size());
+    for (const auto &[room_id, room_metrics] : metrics.rooms)
+    {
+        if (room_metrics.cached)
+            Add(cached_room_cnt_, 1);
+    }
+    Add(calc_cnt_, metrics.calc_cnt);
+    Add(col_cnt_, metrics.col_cnt);
+    Add(nodes_, static_cast<UInt64>(std::max<Int64>(metrics.nodes, 0)));
+    Add(arena_allocations_, metrics.arena_allocations);
+    Add(arena_blocks_, metrics.arena_blocks);
+    AddSeconds(resolve_us_, metrics.resolve_seconds);
+    AddSeconds(params_us_, metrics.params_seconds);
+    AddSeconds(comb_us_, metrics.comb_seconds);
+    AddSeconds(matrix_us_, metrics.matrix_seconds);
+    AddSeconds(cbc_us_, metrics.cbc_seconds);
+    AddSeconds(alternatives_us_, metrics.alternatives_seconds);
+    AddSeconds(marginal_values_us_, metrics.marginal_values_seconds);
+}
+
+void SolveStatistics::AppendInfo(const std::string &prefix, Vector<std::string> &out) const
+{
+    const auto append = [&](const char *key, const std::atomic<UInt64> &counter) {
+        out.push_back(std::string(prefix).append(key).append("=").append(
+            std::to_string(counter.load(std::memory_order_relaxed))));
+    };
+
+    append("solves", solve_cnt_);
+    append("greedy_solves", greedy_solve_cnt_);
+    append("rooms", room_cnt_);
+    append("cached_rooms", cached_room_cnt_);
+    append("calc_cnt", calc_cnt_);
+    append("columns", col_cnt_);
+    append("nodes", nodes_);
+    append("arena_allocations", arena_allocations_);
+    append("arena_blocks", arena_blocks_);
+    append("resolve_us", resolve_us_);
+    append("params_us", params_us_);
+    append("comb_us", comb_us_);
+    append("matrix_us", matrix_us_);
+    append("cbc_us", cbc_us_);
+    append("alternatives_us", alternatives_us_);
+    append("marginal_values_us", marginal_values_us_);
+}
+} // namespace albc::api
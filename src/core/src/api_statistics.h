@@ -0,0 +1,47 @@
+#pragma once
+#include "albc_types.h"
+#include "algorithm_params.h"
+
+#include <atomic>
+#include <string>
+
+namespace albc::api
+{
+/**
+ * @brief 进程内累计的求解统计
+ *
+ * 各项均为原子计数，记录与读取都不加锁，可供健康检查频繁查询。耗时以微秒累计。
+ */
+class SolveStatistics
+{
+  public:
+    void Record(const algorithm::SolveMetrics &metrics) noexcept;
+
+    // 以"键=值"的形式追加所有统计项，键以prefix开头
+    void AppendInfo(const std::string &prefix, Vector<std::string> &out) const;
+
+  private:
+    std::atomic<UInt64> solve_cnt_{0};
+    std::atomic<UInt64> greedy_solve_cnt_{0}; // 因估计的内存超出限制改用贪心的求解数
+    std::atomic<UInt64> room_cnt_{0};
+    std::atomic<UInt64> cached_room_cnt_{0}; // 组合取自会话缓存的房间数
+    std::atomic<UInt64> calc_cnt_{0};
+    std::atomic<UInt64> col_cnt_{0};
+    std::atomic<UInt64> nodes_{0};
+    std::atomic<UInt64> arena_allocations_{0};
+    std::atomic<UInt64> arena_blocks_{0};
+    std::atomic<UInt64> resolve_us_{0};
+    std::atomic<UInt64> params_us_{0};
+    std::atomic<UInt64> comb_us_{0};
+    std::atomic<UInt64> matrix_us_{0};
+    std::atomic<UInt64> cbc_us_{0};
+    std::atomic<UInt64> alternatives_us_{0};
+    std::atomic<UInt64> marginal_values_us_{0};
+};
+
+inline SolveStatistics &GetGlobalSolveStatistics()
+{
+    static SolveStatistics api_global_solve_statistics;
+    return api_global_solve_statistics;
+}
+} // namespace albc::api
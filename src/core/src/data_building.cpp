@@ -2,6 +2,9 @@
 // Created by Nonary on 2022/4/24.
 //
 #include "data_building.h"
+#include "util_xml.h"
+
+#include <future>
 
 namespace albc::data::building
 {
@@ -15,6 +18,7 @@ BuildingBuffCharSlot::BuildingBuffCharSlot(const Json::Value &json)
 {}
 BuildingCharacter::BuildingCharacter(const Json::Value &json)
     : char_id(json["charId"].asString()),
+      char_key(util::intern_string(char_id)),
       max_man_power(json["maxManpower"].asInt64()),
       buff_char(util::json_val_as_ptr_vector<BuildingBuffCharSlot>(json["buffChar"]))
 {}
@@ -24,10 +28,22 @@ BuildingBuff::BuildingBuff(const Json::Value &json)
       skill_icon(json["skillIcon"].asString()),
       sort_id(json["sortId"].asInt()),
       room_type(util::json_string_as_enum(json["roomType"], RoomType::NONE)),
-      description(json["description"].asString())
+      description(json["description"].asString()),
+      name_key(util::intern_string(buff_name)),
+      description_key(util::intern_string(xml::strip_xml_tags(description)))
 {}
 BuildingData::BuildingData(const Json::Value &json)
-    : chars(util::json_val_as_ptr_dictionary<BuildingCharacter>(json["chars"])),
-      buffs(util::json_val_as_ptr_dictionary<BuildingBuff>(json["buffs"]))
-{}
+{
+#ifdef ALBC_HAVE_THREADS
+    constexpr auto kLaunchPolicy = std::launch::async;
+#else
+    constexpr auto kLaunchPolicy = std::launch::deferred;
+#endif
+    // chars与buffs互不依赖，同时构造；两者内部再按成员分块并行
+    auto chars_future = std::async(kLaunchPolicy, [&json]() {
+        return util::json_val_as_ptr_dictionary_parallel<BuildingCharacter>(json["chars"]);
+    });
+    buffs = util::json_val_as_ptr_dictionary_parallel<BuildingBuff>(json["buffs"]);
+    chars = chars_future.get();
+}
 }
\ No newline at end of file
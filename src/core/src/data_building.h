@@ -3,6 +3,7 @@
 #include "util_json.h"
 #include "albc_types.h"
 #include "util.h"
+#include "util_string_interner.h"
 
 #pragma clang diagnostic push
 #pragma ide diagnostic ignored "OCUnusedGlobalDeclarationInspection"
@@ -64,6 +65,7 @@ class BuildingCharacter
 {
   public:
     std::string char_id;
+    util::StringId char_key; // char_id的驻留Id，加载时驻留，干员模型只查找不驻留
     Int64 max_man_power;
     mem::PtrVector<BuildingBuffCharSlot> buff_char;
 
@@ -79,8 +81,15 @@ class BuildingBuff
     int sort_id;
     RoomType room_type;
     std::string description;
+    util::StringId name_key;        // buff_name的驻留Id
+    util::StringId description_key; // 去除xml标签后的描述的驻留Id，加载时计算一次
 
     explicit BuildingBuff(const Json::Value &json);
+
+    [[nodiscard]] const std::string &GetPlainDescription() const
+    {
+        return util::GetGlobalStringInterner().GetString(description_key);
+    }
 };
 
 class BuildingData
@@ -7,6 +7,7 @@
 #include "albc_types.h"
 #include "data_building.h"
 #include "data_character_table.h"
+#include "util_flat_hash_map.h"
 namespace albc::data::game
 {
 class ICharacterLookupTable
@@ -44,7 +45,7 @@ class CharacterLookupTable: public ICharacterLookupTable
   private:
     std::shared_ptr<CharacterTable> character_table_;
     std::shared_ptr<building::BuildingData> building_data_;
-    Dictionary<std::string, std::string> name_to_id_;
-    Dictionary<std::string, std::string> appellation_to_id_;
+    util::FlatHashMap<std::string, std::string> name_to_id_;
+    util::FlatHashMap<std::string, std::string> appellation_to_id_;
 };
 } // namespace albc::data::game
\ No newline at end of file
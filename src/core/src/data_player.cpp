@@ -12,9 +12,33 @@ PlayerCharacter::PlayerCharacter(const Json::Value &json)
 PlayerTroop::PlayerTroop(const Json::Value &json)
     : chars(util::json_val_as_ptr_dictionary<PlayerCharacter>(json["chars"]))
 {}
+PlayerTroop::PlayerTroop(util::JsonStreamReader &reader)
+{
+    reader.ReadObject([&](const std::string &key) {
+        if (key != "chars")
+            return reader.SkipValue();
+
+        reader.ReadObject([&](const std::string &char_key) {
+            chars.emplace(char_key, std::make_unique<PlayerCharacter>(
+                                        reader.ReadObjectFields({"instId", "charId", "level", "exp", "evolvePhase"})));
+        });
+    });
+}
 PlayerDataModel::PlayerDataModel(const Json::Value &json) : troop(json["troop"]),
                                                             building(json["building"])
 {}
+PlayerDataModel::PlayerDataModel(util::JsonStreamReader &reader)
+{
+    reader.ReadObject([&](const std::string &key) {
+        if (key == "troop")
+            troop = PlayerTroop(reader);
+        else if (key == "building")
+            building = PlayerBuilding(reader);
+        else
+            reader.SkipValue();
+    });
+    reader.ExpectEnd();
+}
 PlayerTroopLookup::PlayerTroopLookup(const PlayerTroop &troop)
 {
     for (const auto &[id, char_data] : troop.chars)
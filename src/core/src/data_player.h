@@ -2,6 +2,8 @@
 
 #include "data_building.h"
 #include "util_json.h"
+#include "util_json_stream.h"
+#include "util_flat_hash_map.h"
 #include "data_player_building.h"
 #include "albc_types.h"
 
@@ -27,6 +29,7 @@ class PlayerTroop
 
     PlayerTroop() = default;
     explicit PlayerTroop(const Json::Value &json);
+    explicit PlayerTroop(util::JsonStreamReader &reader);
 };
 
 class PlayerDataModel
@@ -37,6 +40,8 @@ class PlayerDataModel
 
     PlayerDataModel() = default;
     explicit PlayerDataModel(const Json::Value &json);
+    // 流式读取，只构造算法需要的字段，其余子树直接跳过
+    explicit PlayerDataModel(util::JsonStreamReader &reader);
 };
 
 class PlayerTroopLookup
@@ -50,7 +55,7 @@ class PlayerTroopLookup
     [[nodiscard]] std::string GetCharId(int inst_id) const;
 
   private:
-    Dictionary<std::string, int> char_id_to_inst_id;
-    Dictionary<int, std::string> inst_id_to_char_id;
+    util::FlatHashMap<std::string, int> char_id_to_inst_id;
+    util::FlatHashMap<int, std::string> inst_id_to_char_id;
 };
 } // namespace albc::data::player
@@ -83,4 +83,64 @@ PlayerBuilding::PlayerBuilding(const Json::Value &json)
       player_building_room(json["rooms"]), chars(util::json_val_as_ptr_dictionary<PlayerBuildingChar>(json["chars"]))
 {
 }
-}
\ No newline at end of file
+PlayerBuildingRoom::PlayerBuildingRoom(util::JsonStreamReader &reader)
+{
+    reader.ReadObject([&](const std::string &key) {
+        if (key == "MANUFACTURE")
+        {
+            reader.ReadObject([&](const std::string &room_key) {
+                manufacture.emplace(room_key, PlayerBuildingManufacture(reader.ReadObjectFields(
+                                                  {"state", "formulaId", "remainSolutionCnt", "outputSolutionCnt",
+                                                   "capacity", "apCost", "processPoint"})));
+            });
+        }
+        else if (key == "TRADING")
+        {
+            reader.ReadObject([&](const std::string &room_key) {
+                trading.emplace(room_key, PlayerBuildingTrading(reader.ReadObjectFields(
+                                              {"buff", "state", "stockLimit", "stock", "display", "strategy"})));
+            });
+        }
+        else
+        {
+            reader.SkipValue();
+        }
+    });
+}
+PlayerBuilding::PlayerBuilding(util::JsonStreamReader &reader)
+{
+    reader.ReadObject([&](const std::string &key) {
+        if (key == "status")
+        {
+            reader.ReadObject([&](const std::string &status_key) {
+                if (status_key == "labor")
+                    status_labor = PlayerBuildingLabor(reader.ReadValue());
+                else
+                    reader.SkipValue();
+            });
+        }
+        else if (key == "roomSlots")
+        {
+            reader.ReadObject([&](const std::string &slot_key) {
+                room_slots.emplace(slot_key, PlayerBuildingRoomSlot(
+                                                 reader.ReadObjectFields({"level", "state", "roomId", "charInstIds"})));
+            });
+        }
+        else if (key == "rooms")
+        {
+            player_building_room = PlayerBuildingRoom(reader);
+        }
+        else if (key == "chars")
+        {
+            reader.ReadObject([&](const std::string &char_key) {
+                chars.emplace(char_key, std::make_unique<PlayerBuildingChar>(reader.ReadObjectFields(
+                                            {"charId", "roomSlotId", "ap", "index", "changeScale", "workTime"})));
+            });
+        }
+        else
+        {
+            reader.SkipValue();
+        }
+    });
+}
+}
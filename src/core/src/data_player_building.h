@@ -3,6 +3,7 @@
 
 #include "model_buff_primitives.h"
 #include "util_json.h"
+#include "util_json_stream.h"
 #include "util_mem.h"
 #include "albc_types.h"
 #include "json/json.h"
@@ -138,6 +139,7 @@ class PlayerBuildingRoom
 
     PlayerBuildingRoom() = default;
     explicit PlayerBuildingRoom(const Json::Value &json);
+    explicit PlayerBuildingRoom(util::JsonStreamReader &reader);
 };
 
 class PlayerBuilding
@@ -145,6 +147,7 @@ class PlayerBuilding
   public:
     PlayerBuilding() = default;
     explicit PlayerBuilding(const Json::Value &json);
+    explicit PlayerBuilding(util::JsonStreamReader &reader);
 
     PlayerBuildingLabor status_labor{};
     Dictionary<std::string, PlayerBuildingRoomSlot> room_slots;
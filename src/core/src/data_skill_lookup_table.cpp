@@ -75,10 +75,12 @@ ISkillLookupTable::CharQueryEntry SkillLookupTable::QueryCharWithBuffList(const
     if (keys.empty())
         return CharQueryEntry::Empty();
 
-    CompositeHashKey key = HashMultiBuff(keys, char_key);
-    const auto &map = query_map_;
-    auto it = map.find(key);
-    return it != map.end() && it->second.IsValid() ? it->second.char_query : CharQueryEntry::Empty();
+    const auto *map = GetQueryMap(char_key);
+    if (!map)
+        return CharQueryEntry::Empty();
+
+    auto it = map->find(HashMultiBuff(keys));
+    return it != map->end() && it->second.IsValid() ? it->second.char_query : CharQueryEntry::Empty();
 }
 ISkillLookupTable::CharQueryEntry SkillLookupTable::QueryCharWithBuff(const std::string &buff_key,
                                                                      const std::string &char_key) const
@@ -86,15 +88,18 @@ ISkillLookupTable::CharQueryEntry SkillLookupTable::QueryCharWithBuff(const std:
     if (buff_key.empty())
         return CharQueryEntry::Empty();
 
-    CompositeHashKey key = HashSingleBuff(buff_key, char_key);
-    const auto &map = query_map_;
-    auto it = map.find(key);
-    return it != map.end() && it->second.IsValid() ? it->second.char_query : CharQueryEntry::Empty();
+    const auto *map = GetQueryMap(char_key);
+    if (!map)
+        return CharQueryEntry::Empty();
+
+    auto it = map->find(HashSingleBuff(buff_key));
+    return it != map->end() && it->second.IsValid() ? it->second.char_query : CharQueryEntry::Empty();
 }
-SkillLookupTable::SkillLookupTable(std::shared_ptr<building::BuildingData> building_data, // NOLINT(performance-unnecessary-value-param)
-                                   std::shared_ptr<ICharacterLookupTable> char_lookup_table) // NOLINT(performance-unnecessary-value-param)
+SkillLookupTable::SkillLookupTable(std::shared_ptr<building::BuildingData> building_data,
+                                   std::shared_ptr<ICharacterLookupTable> char_lookup_table)
+    : building_data_(std::move(building_data)), char_lookup_table_(std::move(char_lookup_table))
 {
-    for (const auto &[id, buff] : building_data->buffs)
+    for (const auto &[id, buff] : building_data_->buffs)
     {
         name_to_id_[buff->buff_name] = id;
         id_to_name_[id] = buff->buff_name;
@@ -102,99 +107,70 @@ SkillLookupTable::SkillLookupTable(std::shared_ptr<building::BuildingData> build
         exist_icons_.insert(buff->skill_icon);
     }
 
-    for (const auto &[char_id, character] : building_data->chars)
+    // 只记录每个查询表由哪些干员构成，技能组合在首次查询时才生成
+    for (const auto &[char_id, character] : building_data_->chars)
     {
-        // 用于生成该干员在所有可能的等级条件下的技能组合
-        auto cur_phase = EvolvePhase::PHASE_0;
-        int cur_level = 1;
-        Vector<std::string> current;
-        Vector<std::string> current_names;
-        Vector<std::string> current_icons;
-        Vector<std::pair<building::BuildingBuffCharSlot *, building::SlotItem>> buff_cond_nodes;
-        // 同在一个Slot中的buff，当更高级的生效时需要替换掉低级的
-        Dictionary<building::BuildingBuffCharSlot *, building::SlotItem> buff_cond_slots;
-
-        for (const auto &slot : character->buff_char)
-        {
-            for (const auto &slot_item : slot->buff_data)
-            {
-                buff_cond_nodes.push_back({slot.get(), slot_item});
-            }
-        }
+        global_query_map_.char_ids.push_back(char_id);
 
-        // 添加边界条件
-        {
-            auto &[slot, boundary] = buff_cond_nodes.emplace_back();
-            slot = nullptr;
-            boundary.buff_id = "";
-            boundary.cond.phase = EvolvePhase::PHASE_3;
-            boundary.cond.level = INT32_MAX;
-        }
+        auto &id_map = char_query_maps_[char_id];
+        if (!id_map)
+            id_map = std::make_unique<LazyQueryMap>();
+        id_map->char_ids.push_back(char_id);
 
-        // 根据升级条件升序排序buff，得到角色从低级到高级依此解锁的技能顺序
-        std::sort(buff_cond_nodes.begin(), buff_cond_nodes.end(), [](const auto &lhs, const auto &rhs) {
-          return lhs.second.cond.phase < rhs.second.cond.phase && lhs.second.cond.level < rhs.second.cond.level;
-        });
+        const std::string char_name = char_lookup_table_->IdToName(char_id);
+        if (char_name.empty())
+            continue;
 
-        // 生成buff组合
-        for (const auto &[slot, slot_item] : buff_cond_nodes)
-        {
-            if (!slot_item.cond.Check(cur_phase, cur_level))
-            {
-                if (current.empty())
-                    continue;
-
-                CharQueryEntry query{char_id, cur_phase, cur_level};
-                InsertQueryItem(query_map_, saved_entries_, query, current);
-                InsertQueryItem(query_map_, saved_entries_, query, current_names);
-                InsertQueryItem(query_map_, saved_entries_, query, current_icons);
-                InsertQueryItem(query_map_, saved_entries_, query, current, char_id);
-                InsertQueryItem(query_map_, saved_entries_, query, current_names, char_id);
-                InsertQueryItem(query_map_, saved_entries_, query, current_icons, char_id);
-
-                std::string char_name = char_lookup_table->IdToName(char_id);
-                InsertQueryItem(query_map_, saved_entries_, query, current, char_name);
-                InsertQueryItem(query_map_, saved_entries_, query, current_names, char_name);
-                InsertQueryItem(query_map_, saved_entries_, query, current_icons, char_name);
-
-                cur_phase = slot_item.cond.phase;
-                cur_level = slot_item.cond.level;
-            }
-
-            // 跳过边界条件
-            if (slot == nullptr)
-                break;
-
-            if (auto slot_it = buff_cond_slots.find(slot); 
-                slot_it == buff_cond_slots.end())
-            {
-                buff_cond_slots.insert({slot, slot_item});
-                current.push_back(slot_item.buff_id);
-                current_names.push_back(id_to_name_[slot_item.buff_id]);
-                current_icons.push_back(id_to_icon_[slot_item.buff_id]);
-            }
-            else
-            {
-                auto& perv = slot_it->second;
-                util::ReplaceFirst(current.begin(), current.end(), perv.buff_id, slot_item.buff_id);
-                util::ReplaceFirst(current_names.begin(), current_names.end(), id_to_name_[perv.buff_id],
-                                   id_to_name_[slot_item.buff_id]);
-                util::ReplaceFirst(current_icons.begin(), current_icons.end(), id_to_icon_[perv.buff_id],
-                                   id_to_icon_[slot_item.buff_id]);
-                slot_it->second = slot_item;
-            }
-        }
+        auto &name_map = char_query_maps_[char_name];
+        if (!name_map)
+            name_map = std::make_unique<LazyQueryMap>();
+        name_map->char_ids.push_back(char_id);
+    }
+}
+const SkillLookupTable::BuffToCharMap *SkillLookupTable::GetQueryMap(const std::string &char_key) const
+{
+    LazyQueryMap *target = &global_query_map_;
+    if (!char_key.empty())
+    {
+        const auto it = char_query_maps_.find(char_key);
+        if (it == char_query_maps_.end())
+            return nullptr;
+
+        target = it->second.get();
+    }
+
+    std::call_once(target->built, [&] { BuildQueryMap(*target); });
+    return &target->map;
+}
+void SkillLookupTable::BuildQueryMap(LazyQueryMap &target) const
+{
+#ifndef NDEBUG
+    MapEntries *entries = &target.saved_entries;
+#else
+    MapEntries *entries = nullptr;
+#endif
+
+    for (const auto &char_id : target.char_ids)
+    {
+        ForEachUnlockStage(char_id, *building_data_->chars.at(char_id),
+                           [&](const CharQueryEntry &query, const Vector<std::string> &ids,
+                               const Vector<std::string> &names, const Vector<std::string> &icons) {
+                               InsertQueryItem(target.map, entries, query, ids);
+                               InsertQueryItem(target.map, entries, query, names);
+                               InsertQueryItem(target.map, entries, query, icons);
+                           });
     }
 
     // 删除无效条目并输出统计信息
-    UInt32 multi_lookup_count = 0;
-    CleanupBuffLookupMap(query_map_, saved_entries_, multi_lookup_count);
-    LOG_D("Successfully loaded: ", multi_lookup_count, " multi buff lookup items. ");
+    UInt32 valid_count = 0;
+    CleanupBuffLookupMap(target.map, entries, valid_count);
+    LOG_D("Successfully built: ", valid_count, " buff lookup items from ", target.char_ids.size(), " characters.");
 
+#ifndef NDEBUG
     if constexpr (kSkillLookupTableDoDumpEntries)
     {
         Dictionary<std::pair<std::string, Vector<std::string>>, CompositeHashKey> data_ordered_map;
-        for (const auto &[key, data] : saved_entries_)
+        for (const auto &[key, data] : target.saved_entries)
         {
             data_ordered_map.emplace(data, key);
         }
@@ -203,19 +179,94 @@ SkillLookupTable::SkillLookupTable(std::shared_ptr<building::BuildingData> build
         {
             const auto &[char_key, buff_keys] = data;
             util::VariantPutLn(std::cout, std::left,
-                std::setw(24), char_key, 
-                ": ", std::setw(60), util::Join(buff_keys.begin(), buff_keys.end(), ", "), 
-                ": ", query_map_[key].char_query.to_string());
+                std::setw(24), char_key,
+                ": ", std::setw(60), util::Join(buff_keys.begin(), buff_keys.end(), ", "),
+                ": ", target.map[key].char_query.to_string());
         }
     }
     else
     {
-        saved_entries_.clear();
+        target.saved_entries.clear();
+    }
+#endif
+}
+template <typename Func>
+void SkillLookupTable::ForEachUnlockStage(const std::string &char_id, const building::BuildingCharacter &character,
+                                          Func &&func) const
+{
+    // 用于生成该干员在所有可能的等级条件下的技能组合
+    auto cur_phase = EvolvePhase::PHASE_0;
+    int cur_level = 1;
+    Vector<std::string> current;
+    Vector<std::string> current_names;
+    Vector<std::string> current_icons;
+    Vector<std::pair<building::BuildingBuffCharSlot *, building::SlotItem>> buff_cond_nodes;
+    // 同在一个Slot中的buff，当更高级的生效时需要替换掉低级的
+    Dictionary<building::BuildingBuffCharSlot *, building::SlotItem> buff_cond_slots;
+
+    for (const auto &slot : character.buff_char)
+    {
+        for (const auto &slot_item : slot->buff_data)
+        {
+            buff_cond_nodes.push_back({slot.get(), slot_item});
+        }
+    }
+
+    // 添加边界条件
+    {
+        auto &[slot, boundary] = buff_cond_nodes.emplace_back();
+        slot = nullptr;
+        boundary.buff_id = "";
+        boundary.cond.phase = EvolvePhase::PHASE_3;
+        boundary.cond.level = INT32_MAX;
+    }
+
+    // 根据升级条件升序排序buff，得到角色从低级到高级依此解锁的技能顺序
+    std::sort(buff_cond_nodes.begin(), buff_cond_nodes.end(), [](const auto &lhs, const auto &rhs) {
+      return lhs.second.cond.phase < rhs.second.cond.phase && lhs.second.cond.level < rhs.second.cond.level;
+    });
+
+    // 生成buff组合
+    for (const auto &[slot, slot_item] : buff_cond_nodes)
+    {
+        if (!slot_item.cond.Check(cur_phase, cur_level))
+        {
+            if (current.empty())
+                continue;
+
+            func(CharQueryEntry{char_id, cur_phase, cur_level}, current, current_names, current_icons);
+
+            cur_phase = slot_item.cond.phase;
+            cur_level = slot_item.cond.level;
+        }
+
+        // 跳过边界条件
+        if (slot == nullptr)
+            break;
+
+        if (auto slot_it = buff_cond_slots.find(slot);
+            slot_it == buff_cond_slots.end())
+        {
+            buff_cond_slots.insert({slot, slot_item});
+            current.push_back(slot_item.buff_id);
+            current_names.push_back(IdToName(slot_item.buff_id));
+            current_icons.push_back(IdToIcon(slot_item.buff_id));
+        }
+        else
+        {
+            auto& perv = slot_it->second;
+            util::ReplaceFirst(current.begin(), current.end(), perv.buff_id, slot_item.buff_id);
+            util::ReplaceFirst(current_names.begin(), current_names.end(), IdToName(perv.buff_id),
+                               IdToName(slot_item.buff_id));
+            util::ReplaceFirst(current_icons.begin(), current_icons.end(), IdToIcon(perv.buff_id),
+                               IdToIcon(slot_item.buff_id));
+            slot_it->second = slot_item;
+        }
     }
 }
 void SkillLookupTable::InsertQueryItem(
-    std::unordered_map<CompositeHashKey, MapEntry> &target,
-    MapEntries &entries, const CharQueryEntry &query, const Vector<std::string> &buff_keys, const std::string &char_key)
+    BuffToCharMap &target,
+    MapEntries *entries, const CharQueryEntry &query, const Vector<std::string> &buff_keys, const std::string &char_key)
 {
     InsertMultiBuffLookupItem(target, entries, query, buff_keys, char_key);
     for (const auto &id : buff_keys)
@@ -258,19 +309,19 @@ SkillLookupTable::CompositeHashKey SkillLookupTable::HashSingleBuff(const std::s
     return key;
 }
 void SkillLookupTable::InsertMultiBuffLookupItem(
-    std::unordered_map<CompositeHashKey, MapEntry> &target,
-    MapEntries &entries, const CharQueryEntry &query, const Vector<std::string> &buff_keys, const std::string &char_key)
+    BuffToCharMap &target,
+    MapEntries *entries, const CharQueryEntry &query, const Vector<std::string> &buff_keys, const std::string &char_key)
 {
     if (!query.HasContent())
         throw std::invalid_argument("InsertMultiBuffLookupItem(): char_id is empty");
 
     CompositeHashKey key = HashMultiBuff(buff_keys, char_key);
-    if (target[key].TryUpdateWithTighterBound(query))
-        entries[key] = {char_key, buff_keys};
+    if (target[key].TryUpdateWithTighterBound(query) && entries)
+        (*entries)[key] = {char_key, buff_keys};
 }
 void SkillLookupTable::InsertSingleBuffLookupItem(
-    std::unordered_map<CompositeHashKey, MapEntry> &target,
-    MapEntries &entries, const CharQueryEntry &query, const std::string &buff_key, bool is_lax_bound, const std::string &char_key)
+    BuffToCharMap &target,
+    MapEntries *entries, const CharQueryEntry &query, const std::string &buff_key, bool is_lax_bound, const std::string &char_key)
 {
     if (!query.HasContent())
         throw std::invalid_argument("InsertSingleBuffLookupItem(): char_id is empty");
@@ -280,24 +331,21 @@ void SkillLookupTable::InsertSingleBuffLookupItem(
         (!is_lax_bound && target[key].TryUpdateWithTighterBound(query))
         || (is_lax_bound && target[key].TryUpdateWithLaxerBound(query)))
     {
-        entries[key] = {char_key, {buff_key}};
+        if (entries)
+            (*entries)[key] = {char_key, {buff_key}};
     }
 }
-void SkillLookupTable::CleanupBuffLookupMap(
-    std::unordered_map<CompositeHashKey, MapEntry> &target, MapEntries &entries, UInt32 &valid_count)
+void SkillLookupTable::CleanupBuffLookupMap(BuffToCharMap &target, MapEntries *entries, UInt32 &valid_count)
 {
-    for (auto it = target.begin(); it != target.end();)
-    {
-        if (!it->second.IsValid())
-        {
-            entries.erase(it->first);
-            it = target.erase(it);
-            continue;
-        }
+    target.erase_if([&](const auto &item) {
+        if (item.second.IsValid())
+            return false;
 
-        ++valid_count;
-        ++it;
-    }
+        if (entries)
+            entries->erase(item.first);
+        return true;
+    });
+    valid_count = static_cast<UInt32>(target.size());
 }
 bool SkillLookupTable::MapEntry::IsValid() const
 {
@@ -6,7 +6,9 @@
 #include "data_game.h"
 #include "util_log.h"
 #include "albc_types.h"
+#include "util_flat_hash_map.h"
 
+#include <mutex>
 #include <unordered_set>
 
 namespace albc::data::game
@@ -77,6 +79,8 @@ class SkillLookupTable : public ISkillLookupTable
                               std::shared_ptr<ICharacterLookupTable> char_lookup_table);
 
   private:
+    std::shared_ptr<building::BuildingData> building_data_;
+    std::shared_ptr<ICharacterLookupTable> char_lookup_table_;
     std::unordered_map<std::string, std::string> name_to_id_;
     std::unordered_map<std::string, std::string> id_to_name_;
     std::unordered_set<std::string> exist_icons_;
@@ -97,21 +101,40 @@ class SkillLookupTable : public ISkillLookupTable
         bool TryUpdateWithLaxerBound(const CharQueryEntry &char_query_val);
     };
 
-    using BuffToCharMap = std::unordered_map<CompositeHashKey, MapEntry>;
+    using BuffToCharMap = util::FlatHashMap<CompositeHashKey, MapEntry>;
     using MapEntries = Dictionary<CompositeHashKey, std::pair<std::string, Vector<std::string>>>;
 
-    // 多buff/单buff/干员+多buff/干员+单buff/到干员的查询表
-    // buff_id(s) / buff_name(s) -> CharQueryItem
-    // char_id/name + buff_id(s) / char_id/name + buff_name(s)-> CharQueryItem
-    // id和名字共用一个map（因为不会冲突）
-    // 不支持模糊查询
-    BuffToCharMap query_map_;
-    MapEntries saved_entries_;
+    // 首次查询时才构造的查询表
+    struct LazyQueryMap
+    {
+        std::once_flag built;
+        Vector<std::string> char_ids; // 参与构造的干员
+        BuffToCharMap map;
+#ifndef NDEBUG
+        MapEntries saved_entries; // 仅供调试输出
+#endif
+    };
+
+    // 多buff/单buff -> CharQueryItem，键为buff_id(s) / buff_name(s) / buff_icon(s)
+    // id、名字和图标共用一个map（因为不会冲突），不支持模糊查询
+    // 不指定干员的查询需要全体干员参与构造，因此单独一张表；指定干员（ID或名字）时只构造对应干员的表
+    mutable LazyQueryMap global_query_map_;
+    std::unordered_map<std::string, std::unique_ptr<LazyQueryMap>> char_query_maps_;
     static constexpr std::string_view kSingleBuffHashKey = "single_buff";
     static constexpr std::string_view kMultiBuffHashKey = "multi_buff";
     static constexpr std::string_view kCharHashKey = "with_char_key";
 
-    static void InsertQueryItem(BuffToCharMap &target, MapEntries &entries, const CharQueryEntry &query,
+    // 取得char_key对应的查询表（为空时为全局表），必要时先构造；char_key未知时返回nullptr
+    [[nodiscard]] const BuffToCharMap *GetQueryMap(const std::string &char_key) const;
+
+    void BuildQueryMap(LazyQueryMap &target) const;
+
+    // 按解锁顺序枚举干员在各等级条件下拥有的技能组合（ID、名字、图标）
+    template <typename Func>
+    void ForEachUnlockStage(const std::string &char_id, const building::BuildingCharacter &character,
+                            Func &&func) const;
+
+    static void InsertQueryItem(BuffToCharMap &target, MapEntries *entries, const CharQueryEntry &query,
                                 const Vector<std::string> &buff_keys, const std::string &char_key = {});
 
     static CompositeHashKey HashStringCollection(const Vector<std::string> &list);
@@ -122,13 +145,13 @@ class SkillLookupTable : public ISkillLookupTable
 
     static CompositeHashKey HashSingleBuff(const std::string &buff_key, const std::string &char_key = {});
 
-    static void InsertMultiBuffLookupItem(BuffToCharMap &target, MapEntries &entries,
+    static void InsertMultiBuffLookupItem(BuffToCharMap &target, MapEntries *entries,
                                           const CharQueryEntry &query, const Vector<std::string> &buff_keys, const std::string &char_key = {});
 
-    static void InsertSingleBuffLookupItem(BuffToCharMap &target, MapEntries &entries,
+    static void InsertSingleBuffLookupItem(BuffToCharMap &target, MapEntries *entries,
                                            const CharQueryEntry &query, const std::string &buff_key, bool is_lax_bound, const std::string &char_key = {});
 
-    static void CleanupBuffLookupMap(BuffToCharMap &target, MapEntries &entries, UInt32 &valid_count);
+    static void CleanupBuffLookupMap(BuffToCharMap &target, MapEntries *entries, UInt32 &valid_count);
 };
 
 } // namespace albc::data::game
\ No newline at end of file
@@ -22,7 +22,8 @@ RoomBuff::RoomBuff()
     sort_id(0),
     duration(86400),
     prototype(static_cast<RoomBuff *>(this)),
-    is_mutex(false)
+    is_mutex(false),
+    prototype_data_(std::make_unique<RoomBuffPrototypeData>())
 {
 }
 RoomBuff::RoomBuff(data::building::RoomType room_type, RoomBuffType inner_type)
@@ -32,17 +33,48 @@ RoomBuff::RoomBuff(data::building::RoomType room_type, RoomBuffType inner_type)
       sort_id(0),
       duration(86400),
       prototype(static_cast<RoomBuff *>(this)),
-      is_mutex(false)
+      is_mutex(false),
+      prototype_data_(std::make_unique<RoomBuffPrototypeData>())
 {
 }
+RoomBuff::RoomBuff(const RoomBuff &src)
+    : owner_inst_id(src.owner_inst_id),
+      owner_char_key(src.owner_char_key),
+      name_key(src.name_key),
+      description_key(src.description_key),
+      inner_type(src.inner_type),
+      room_type(src.room_type),
+      sort_id(src.sort_id),
+      duration(src.duration),
+      applier(src.applier),
+      prototype(src.prototype),
+      is_mutex(src.is_mutex)
+{
+}
+void RoomBuff::InitPrototypeId(const std::string &buff_id)
+{
+    assert(this == prototype && "only prototype holds buff id!");
+    prototype_data_->buff_id = buff_id;
+    prototype_data_->buff_key = util::intern_string(buff_id);
+    prototype_data_->patch_target_keys.clear();
+    for (const auto &target : prototype_data_->patch_targets)
+        prototype_data_->patch_target_keys.push_back(util::intern_string(target));
+}
+void RoomBuff::AddPatchTarget(std::string buff_id)
+{
+    assert(this == prototype && "patch targets can only be added to prototype!");
+    prototype_data_->patch_targets.push_back(std::move(buff_id));
+}
 bool RoomBuff::ValidateTarget(const RoomModel *room)
 {
+    const auto &validators = GetPrototypeData().validators;
     return std::all_of(validators.begin(), validators.end(),
                        [room](const std::shared_ptr<RoomBuffTargetValidator>& validator) -> bool { return validator->validate(room); });
 }
 RoomBuff *RoomBuff::AddValidator(RoomBuffTargetValidator *validator)
 {
-    validators.emplace_back(validator);
+    assert(this == prototype && "validators can only be added to prototype!");
+    prototype_data_->validators.emplace_back(validator);
     return this;
 }
 void RoomBuff::UpdateScopeOnNeed(const ModifierScopeData &data)
@@ -239,7 +271,7 @@ JayeTradeBuff::JayeTradeBuff(bool is_above_elite_one)
     applier.scope.type = ModifierScopeType::DEPEND_ON_OTHER_CHAR;
 
     if (is_above_elite_one)
-        this->patch_targets.push_back("trade_ord_limit_diff[000]"); // 干掉孑哥的满血buff
+        AddPatchTarget("trade_ord_limit_diff[000]"); // 干掉孑哥的满血buff
 }
 void JayeTradeBuff::UpdateScope(const ModifierScopeData &data)
 {
@@ -318,7 +350,7 @@ TexasTradeBuff::TexasTradeBuff(bool affected_by_angel)
 {
     if (affected_by_angel)
     {
-        this->patch_targets = {"trade_ord_spd&cost_P[000]"};
+        AddPatchTarget("trade_ord_spd&cost_P[000]");
     }
 
     applier.scope.type = ModifierScopeType::DEPEND_ON_OTHER_CHAR;
@@ -3,10 +3,12 @@
 #include "model_buff_primitives.h"
 #include "data_building.h"
 #include "util_log.h"
+#include "util_arena.h"
 #include "util_mem.h"
 #include "data_player.h"
 #include "albc_types.h"
 #include "util.h"
+#include "util_string_interner.h"
 #include <algorithm>
 #include <cstdarg>
 
@@ -56,25 +58,37 @@ class ModifierApplier
     void MarkInvalid();
 };
 
+/**
+ * @brief 只存放在原型上、由所有克隆共享的不可变数据
+ */
+struct RoomBuffPrototypeData
+{
+    std::string buff_id;                                                 // Buff的Id
+    util::StringId buff_key = util::kEmptyStringId;                     // buff_id的驻留Id
+    Vector<std::string> patch_targets;                                   //指定该buff将会替代掉哪些buff的效果
+    Vector<util::StringId> patch_target_keys;                            // patch_targets的驻留Id
+    mem::PtrVector<RoomBuffTargetValidator, std::shared_ptr> validators; //作用范围验证器
+};
+
 /**
  * @brief 房间buff
+ *
+ * 原型由BuffMap持有，每个干员持有原型的克隆。Id、替代目标和验证器只保存在原型上，克隆通过prototype访问；
+ * 名称和描述以驻留Id保存，克隆只包含干员相关的状态，复制时不分配堆内存。
  */
 class RoomBuff
 {
   public:
     int owner_inst_id;  //拥有该Buff的干员的实例Id
-    std::string owner_char_id{}; //拥有该Buff的角色Id
-    std::string buff_id{};       // Buff的Id
-    std::string name;
-    std::string description;
+    util::StringId owner_char_key = util::kEmptyStringId; //拥有该Buff的角色Id
+    util::StringId name_key = util::kEmptyStringId;
+    util::StringId description_key = util::kEmptyStringId;
     RoomBuffType inner_type{RoomBuffType::UNDEFINED}; //内部类型
-    mem::PtrVector<RoomBuffTargetValidator, std::shared_ptr> validators;     //作用范围验证器
     data::building::RoomType room_type{data::building::RoomType::NONE};       //作用房间类型
     int sort_id;                                  //排序id
     double duration;                          //持续时间，由干员的心情决定
     ModifierApplier applier{};
     RoomBuff *const prototype;
-    Vector<std::string> patch_targets; //指定该buff将会替代掉哪些buff的效果
     bool is_mutex;        //是否会与同类Buff互斥
 
     RoomBuff();
@@ -83,12 +97,48 @@ class RoomBuff
 
     virtual ~RoomBuff() = default;
 
-    RoomBuff(const RoomBuff &src) = default;
+    // 克隆不复制原型数据
+    RoomBuff(const RoomBuff &src);
     RoomBuff &operator=(const RoomBuff &rhs) = delete;
-    RoomBuff(RoomBuff &&src) noexcept = default;
-    RoomBuff &operator=(RoomBuff &&src) noexcept = delete;
+    // 原型的prototype指向自身，移动后会指向已移出的对象，因此禁止移动
+    RoomBuff(RoomBuff &&src) = delete;
+    RoomBuff &operator=(RoomBuff &&src) = delete;
 
-    virtual RoomBuff *Clone() = 0;
+    [[nodiscard]] const RoomBuffPrototypeData &GetPrototypeData() const
+    {
+        return *prototype->prototype_data_;
+    }
+
+    [[nodiscard]] const std::string &GetBuffId() const
+    {
+        return GetPrototypeData().buff_id;
+    }
+
+    [[nodiscard]] util::StringId GetBuffKey() const
+    {
+        return GetPrototypeData().buff_key;
+    }
+
+    [[nodiscard]] const std::string &GetOwnerCharId() const
+    {
+        return util::GetGlobalStringInterner().GetString(owner_char_key);
+    }
+
+    [[nodiscard]] const std::string &GetName() const
+    {
+        return util::GetGlobalStringInterner().GetString(name_key);
+    }
+
+    [[nodiscard]] const std::string &GetDescription() const
+    {
+        return util::GetGlobalStringInterner().GetString(description_key);
+    }
+
+    // 由BuffMap在初始化完成后设置Id并驻留替代目标
+    void InitPrototypeId(const std::string &buff_id);
+
+    // arena为空时由new分配
+    virtual RoomBuff *Clone(mem::MonotonicArena *arena) = 0;
 
     virtual bool ValidateTarget(const RoomModel *room);
 
@@ -104,7 +154,13 @@ class RoomBuff
 
     void UpdateScopeOnNeed(const ModifierScopeData &data);
 
+  protected:
+    // 只能在构造原型时调用
+    void AddPatchTarget(std::string buff_id);
+
   private:
+    std::unique_ptr<RoomBuffPrototypeData> prototype_data_; // 只有原型持有，克隆为空
+
     [[nodiscard]] bool NeedUpdateScope(const ModifierScopeData &data) const;
 };
 
@@ -117,10 +173,13 @@ template <typename TDerived> class CloneableRoomBuff : public RoomBuff
     // inherit constructor
     using RoomBuff::RoomBuff;
 
-    RoomBuff *Clone() final
+    RoomBuff *Clone(mem::MonotonicArena *arena) final
     {
-        return prototype == this ? new TDerived(static_cast<const TDerived &>(*this))
-                                 : prototype->Clone();
+        if (prototype != this)
+            return prototype->Clone(arena);
+
+        const auto &self = static_cast<const TDerived &>(*this);
+        return arena ? arena->New<TDerived>(self) : new TDerived(self);
     }
 };
 
@@ -6,9 +6,9 @@
 namespace albc::model::buff
 {
 
-std::shared_ptr<const std::map<std::string, RoomBuff*>> BuffMap::instance()
+std::shared_ptr<const BuffDictionary> BuffMap::instance()
 {
-    static std::shared_ptr<const Dictionary<std::string, RoomBuff *>> instance{new BuffMap()};
+    static std::shared_ptr<const BuffDictionary> instance{new BuffMap()};
     return instance;
 }
 BuffMap::~BuffMap()
@@ -24,13 +24,13 @@ BuffMap::BuffMap()
 {
     init_buffs(*this);
 }
-void init_buffs(Dictionary<std::string, RoomBuff *> &buffs)
+void init_buffs(BuffDictionary &buffs)
 {
     const auto& sc = SCOPE_TIMER_WITH_TRACE("Initialize Buffs");
     const auto& defer = util::make_defer([&buffs]() {
         for (auto &[id, buff] : buffs)
         {
-            buff->buff_id = id;
+            buff->InitPrototypeId(id);
         }
     });
 
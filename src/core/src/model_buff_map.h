@@ -3,15 +3,19 @@
 #include "model_buff.h"
 #include "albc_types.h"
 #include "util_time.h"
+#include "util_flat_hash_map.h"
 
 namespace albc::model::buff
 {
-void init_buffs(Dictionary<std::string, RoomBuff *> &buffs);
+// 每次AddBuff都会查找，使用开放寻址哈希表代替std::map
+using BuffDictionary = util::FlatHashMap<std::string, RoomBuff *>;
 
-class BuffMap : public Dictionary<std::string, RoomBuff *>
+void init_buffs(BuffDictionary &buffs);
+
+class BuffMap : public BuffDictionary
 {
   public:
-    static std::shared_ptr<const Dictionary<std::string, RoomBuff *>> instance();
+    static std::shared_ptr<const BuffDictionary> instance();
 
     virtual ~BuffMap();
 
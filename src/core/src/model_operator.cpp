@@ -3,29 +3,33 @@
 //
 #include "model_operator.h"
 #include "model_buff_map.h"
-#include "util_xml.h"
 #include "util_flag.h"
 
 namespace albc::model
 {
 OperatorModel::OperatorModel(const data::player::PlayerCharacter &player_char,
-                             const data::player::PlayerBuildingChar &building_char)
+                             const data::player::PlayerBuildingChar &building_char, mem::MonotonicArena *arena)
     : inst_id(player_char.inst_id),
       char_id(player_char.char_id),
+      char_key(util::find_interned_string(char_id)),
       room_type_mask(data::building::RoomType::NONE),
-      duration(building_char.ap)
+      duration(building_char.ap),
+      arena(arena)
 {
 }
-OperatorModel::OperatorModel(int inst_id, std::string char_id, UInt32 duration)
+OperatorModel::OperatorModel(int inst_id, std::string char_id, UInt32 duration, mem::MonotonicArena *arena)
     : inst_id(inst_id),
       char_id(std::move(char_id)),
+      char_key(util::find_interned_string(this->char_id)),
       room_type_mask(data::building::RoomType::NONE),
-      duration(duration)
+      duration(duration),
+      arena(arena)
 {
 }
 OperatorModel::~OperatorModel()
 {
-    mem::free_ptr_vector(this->buffs);
+    if (!arena)
+        mem::free_ptr_vector(this->buffs);
 }
 void OperatorModel::Empower(const data::player::PlayerTroopLookup &lookup,
                             const data::player::PlayerCharacter &player_char,
@@ -64,26 +68,31 @@ void OperatorModel::Empower(const data::player::PlayerTroopLookup &lookup,
 bool OperatorModel::AddBuff(const data::player::PlayerTroopLookup &lookup,
                             const data::building::BuildingData &building_data, const std::string &buff_id)
 {
-    if (std::any_of(this->buffs.begin(), this->buffs.end(), [&](const auto &buff) { return buff->buff_id == buff_id; }))
+    // 先查找原型，使用原型上的驻留Id比较，不在每次添加时访问全局驻留表
+    const auto buff_map = buff::BuffMap::instance();
+    const auto prototype_it = buff_map->find(buff_id);
+    if (prototype_it == buff_map->end())
     {
-        LOG_W("Buff already exists! : ", buff_id, " on ", char_id);
         return false;
     }
 
-    const auto buff_map = buff::BuffMap::instance();
-    if (!buff_map->count(buff_id))
+    const auto buff_key = prototype_it->second->GetBuffKey();
+    if (std::any_of(this->buffs.begin(), this->buffs.end(), [&](const auto &buff) { return buff->GetBuffKey() == buff_key; }))
     {
+        LOG_W("Buff already exists! : ", buff_id, " on ", char_id);
         return false;
     }
-    auto buff = buff_map->at(buff_id)->Clone();
-    assert(!buff->buff_id.empty());
+
+    auto buff = prototype_it->second->Clone(arena);
+    assert(!buff->GetBuffId().empty());
 
     buff->owner_inst_id = inst_id;
-    buff->owner_char_id = char_id;
-    buff->name = building_data.buffs.at(buff->buff_id)->buff_name;
-    buff->description = xml::strip_xml_tags(building_data.buffs.at(buff->buff_id)->description);
+    buff->owner_char_key = char_key;
+    const auto &buff_def = building_data.buffs.at(buff_id);
+    buff->name_key = buff_def->name_key;
+    buff->description_key = buff_def->description_key;
     buff->duration = duration;
-    buff->sort_id = building_data.buffs.at(buff->buff_id)->sort_id;
+    buff->sort_id = buff_def->sort_id;
     buff->UpdateLookup(lookup);
     this->buffs.push_back(buff);
 
@@ -92,28 +101,39 @@ bool OperatorModel::AddBuff(const data::player::PlayerTroopLookup &lookup,
 }
 void OperatorModel::ResolvePatches()
 {
-    Set<std::string> patch_target;
+    Vector<util::StringId> patch_target;
 
     for (const auto buff : this->buffs)
     {
-        for (const auto &patch : buff->patch_targets)
+        for (const auto patch : buff->GetPrototypeData().patch_target_keys)
         {
-            patch_target.insert(patch); // 暂不考虑复杂情况
+            patch_target.push_back(patch); // 暂不考虑复杂情况
         }
     }
 
+    if (patch_target.empty())
+        return;
+
     buffs.erase(std::remove_if(buffs.begin(), buffs.end(),
-                               [patch_target](const buff::RoomBuff *buff) -> bool {
-                                 bool remove = patch_target.count(buff->buff_id);
+                               [this, &patch_target](const buff::RoomBuff *buff) -> bool {
+                                 bool remove = std::find(patch_target.begin(), patch_target.end(), buff->GetBuffKey())
+                                               != patch_target.end();
                                  if (remove)
                                  {
-                                     LOG_D("Patching buff ", buff->buff_id,
-                                           " of operator ", buff->owner_char_id);
+                                     LOG_D("Patching buff ", buff->GetBuffId(),
+                                           " of operator ", buff->GetOwnerCharId());
 
-                                     delete buff;
+                                     if (!arena) // 内存池中的buff在内存池释放时销毁
+                                         delete buff;
                                  }
                                  return remove;
                                }),
                 buffs.end());
 }
+void OperatorModel::SetSpCharGroup(std::string group)
+{
+    // 异格组取自角色元数据表，属于游戏数据
+    sp_char_group = std::move(group);
+    sp_char_group_key = util::intern_string(sp_char_group);
+}
 }
@@ -3,6 +3,7 @@
 #include "data_building.h"
 #include "data_player.h"
 #include "albc_types.h"
+#include "util_string_interner.h"
 
 namespace albc::model
 {
@@ -13,13 +14,16 @@ public:
     std::string char_id;                     // 游戏数据ID
     std::string identifier;                  // 自定义标识符
     std::string sp_char_group;               // 是否是异格干员，同一个异格干员组中的干员不能同时存在在排班结果中
+    util::StringId char_key = util::kEmptyStringId;          // char_id的驻留Id，游戏数据中不存在的角色为kEmptyStringId
+    util::StringId sp_char_group_key = util::kEmptyStringId; // sp_char_group的驻留Id
     data::building::RoomType room_type_mask; // 可以放置的房间类型, 位掩码
     Vector<buff::RoomBuff *> buffs;          // 所有buff
     UInt32 duration;                         // 干员在1X倍率下的剩余可工作时间, 单位: 秒
+    mem::MonotonicArena *arena;              // buff的分配来源, 非空时buff由内存池持有, 为空时由干员释放
 
     OperatorModel(const data::player::PlayerCharacter &player_char,
-                  const data::player::PlayerBuildingChar &building_char);
-    OperatorModel(int inst_id, std::string char_id, UInt32 duration);
+                  const data::player::PlayerBuildingChar &building_char, mem::MonotonicArena *arena = nullptr);
+    OperatorModel(int inst_id, std::string char_id, UInt32 duration, mem::MonotonicArena *arena = nullptr);
 
     OperatorModel(const OperatorModel &other) = delete;
     OperatorModel &operator=(const OperatorModel &other) = delete;
@@ -35,5 +39,7 @@ public:
                  const std::string &buff_id);
 
     void ResolvePatches();
+
+    void SetSpCharGroup(std::string group);
 };
 } // namespace albc
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include <sstream>
 #include <thread>
 #include <cstring>
+#include <functional>
 
 #if __has_include(<cxxabi.h>)
 #include <cxxabi.h>
@@ -63,8 +64,8 @@ namespace albc::util
         return std::round(val * 1e7) * 1e-7;
     }
 
-    // C(n, k)
-    constexpr UInt32 n_choose_k(const UInt32 n, UInt32 k)
+    // C(n, k)，溢出时返回UINT64_MAX
+    constexpr UInt64 n_choose_k(const UInt32 n, UInt32 k)
     {
         if (k > n)
             return 0;
@@ -73,15 +74,34 @@ namespace albc::util
         if (k == 0)
             return 1;
 
-        UInt32 result = n;
+        UInt64 result = n;
         for (UInt32 i = 2; i <= k; ++i)
         {
-            result *= (n - i + 1);
-            result /= i;
+            // result * m / i 必为整数，拆成两部分计算以免中间结果溢出
+            const UInt64 m = n - i + 1;
+            if (result / i > UINT64_MAX / m)
+                return UINT64_MAX;
+            const UInt64 high = result / i * m;
+            const UInt64 low = result % i * m / i;
+            if (high > UINT64_MAX - low)
+                return UINT64_MAX;
+            result = high + low;
         }
         return result;
     }
 
+    // 饱和加法，溢出时返回UINT64_MAX
+    constexpr UInt64 saturating_add(const UInt64 a, const UInt64 b)
+    {
+        return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+    }
+
+    // 饱和乘法，溢出时返回UINT64_MAX
+    constexpr UInt64 saturating_mul(const UInt64 a, const UInt64 b)
+    {
+        return b != 0 && a > UINT64_MAX / b ? UINT64_MAX : a * b;
+    }
+
     // convert an enum value to a string, using magic enum
     // use std::enable_if and std::is_enum_v<T> to check if T is an enum
     template <typename T>
@@ -114,6 +134,32 @@ namespace albc::util
         }
     };
 
+    // 将value的哈希值合并到seed中，同boost::hash_combine
+    template <typename T>
+    void hash_combine(size_t &seed, const T &value)
+    {
+        seed ^= std::hash<T>{}(value) + static_cast<size_t>(0x9e3779b97f4a7c15ULL) + (seed << 6) + (seed >> 2);
+    }
+
+    // 64位FNV-1a哈希，结果与平台及进程无关，可用于持久化的键。传入上一次的结果作为seed可分段计算
+    constexpr UInt64 kFnv1a64Offset = 0xcbf29ce484222325ULL;
+
+    inline UInt64 fnv1a64(const void *data, size_t size, UInt64 seed = kFnv1a64Offset)
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        for (size_t i = 0; i < size; ++i)
+        {
+            seed ^= p[i];
+            seed *= 0x100000001b3ULL;
+        }
+        return seed;
+    }
+
+    inline UInt64 fnv1a64(std::string_view str, UInt64 seed = kFnv1a64Offset)
+    {
+        return fnv1a64(str.data(), str.size(), seed);
+    }
+
     template <typename TU> 
     static constexpr bool is_pow_of_two(TU n)
     {
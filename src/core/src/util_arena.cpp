@@ -0,0 +1,68 @@
+#include "util_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace albc::mem
+{
+MonotonicArena::MonotonicArena(size_t initial_block_size)
+    : next_block_size_(std::max(initial_block_size, sizeof(Block) + alignof(std::max_align_t)))
+{
+}
+
+MonotonicArena::~MonotonicArena()
+{
+    for (auto node = destructors_; node; node = node->next)
+        node->destroy(node->obj);
+
+    while (block_)
+    {
+        const auto prev = block_->prev;
+        std::free(block_);
+        block_ = prev;
+    }
+}
+
+void *MonotonicArena::Allocate(size_t size, size_t align)
+{
+    ++stats_.allocations;
+    stats_.bytes += size;
+    return AllocateRaw(size, align);
+}
+
+void *MonotonicArena::AllocateRaw(size_t size, size_t align)
+{
+    auto aligned = [align](char *p) {
+        return reinterpret_cast<char *>((reinterpret_cast<std::uintptr_t>(p) + align - 1) & ~(align - 1));
+    };
+
+    char *p = aligned(cur_);
+    if (!cur_ || p + size > end_)
+    {
+        NewBlock(size + align);
+        p = aligned(cur_);
+    }
+    cur_ = p + size;
+    return p;
+}
+
+void MonotonicArena::NewBlock(size_t min_size)
+{
+    // 块大小按倍数增长，对象较多时块数保持在对数级别
+    const size_t size = std::max(next_block_size_, sizeof(Block) + min_size);
+    next_block_size_ = std::min(next_block_size_ * 2, kMaxBlockSize);
+
+    const auto block = static_cast<Block *>(std::malloc(size));
+    if (!block)
+        throw std::bad_alloc();
+
+    block->prev = block_;
+    block_ = block;
+    cur_ = reinterpret_cast<char *>(block + 1);
+    end_ = reinterpret_cast<char *>(block) + size;
+
+    ++stats_.blocks;
+    stats_.reserved += size;
+}
+} // namespace albc::mem
@@ -0,0 +1,88 @@
+#pragma once
+#include "albc_types.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace albc::mem
+{
+/**
+ * @brief 单调增长的内存池，分配只移动块内的指针，不支持单独释放
+ *
+ * 非平凡析构的对象在创建时登记析构函数，内存池析构时按创建的逆序销毁所有对象，再一次性归还全部内存块。
+ * 非线程安全。
+ */
+class MonotonicArena
+{
+  public:
+    struct Stats
+    {
+        size_t allocations = 0; // 从内存池分配的次数，即不使用内存池时的堆分配次数
+        size_t bytes = 0;       // 分配的总字节数
+        size_t blocks = 0;      // 实际向堆申请的内存块数
+        size_t reserved = 0;    // 内存块的总大小
+    };
+
+    static constexpr size_t kDefaultBlockSize = 16 * 1024;
+
+    explicit MonotonicArena(size_t initial_block_size = kDefaultBlockSize);
+    ~MonotonicArena();
+
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    [[nodiscard]] void *Allocate(size_t size, size_t align);
+
+    // 在内存池中构造对象，对象在内存池析构时销毁
+    template <typename T, typename... TArgs> T *New(TArgs &&...args)
+    {
+        // 先分配登记节点，构造完成后不会再因分配失败而漏掉析构
+        DestructorNode *node = nullptr;
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            node = static_cast<DestructorNode *>(AllocateRaw(sizeof(DestructorNode), alignof(DestructorNode)));
+
+        T *obj = new (Allocate(sizeof(T), alignof(T))) T(std::forward<TArgs>(args)...);
+
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            node->obj = obj;
+            node->destroy = [](void *p) { static_cast<T *>(p)->~T(); };
+            node->next = destructors_;
+            destructors_ = node;
+        }
+        return obj;
+    }
+
+    [[nodiscard]] const Stats &GetStats() const
+    {
+        return stats_;
+    }
+
+  private:
+    struct Block
+    {
+        Block *prev;
+    };
+
+    struct DestructorNode
+    {
+        void *obj;
+        void (*destroy)(void *);
+        DestructorNode *next;
+    };
+
+    static constexpr size_t kMaxBlockSize = 1024 * 1024;
+
+    Block *block_ = nullptr;
+    char *cur_ = nullptr;
+    char *end_ = nullptr;
+    size_t next_block_size_;
+    DestructorNode *destructors_ = nullptr;
+    Stats stats_;
+
+    void *AllocateRaw(size_t size, size_t align);
+    void NewBlock(size_t min_size);
+};
+} // namespace albc::mem
@@ -0,0 +1,321 @@
+#pragma once
+#include "albc_types.h"
+
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+namespace albc::util
+{
+/**
+ * @brief 开放寻址（线性探测）的哈希表，所有元素连续存放在一个数组中
+ *
+ * 接口与std::unordered_map的常用部分保持一致。删除使用后移删除（backward shift），不留墓碑。
+ * 插入可能导致扩容，扩容后所有迭代器和引用失效。
+ */
+template <typename TKey, typename TValue, typename THash = std::hash<TKey>, typename TEqual = std::equal_to<TKey>>
+class FlatHashMap
+{
+  public:
+    using key_type = TKey;
+    using mapped_type = TValue;
+    using value_type = std::pair<TKey, TValue>;
+    using size_type = size_t;
+
+  private:
+    using Slot = std::optional<value_type>;
+
+    template <bool IsConst> class IteratorBase
+    {
+        using SlotPtr = std::conditional_t<IsConst, const Slot *, Slot *>;
+        SlotPtr cur_ = nullptr;
+        SlotPtr end_ = nullptr;
+
+        void SkipEmpty()
+        {
+            while (cur_ != end_ && !cur_->has_value())
+                ++cur_;
+        }
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<IsConst, const value_type &, value_type &>;
+        using pointer = std::conditional_t<IsConst, const value_type *, value_type *>;
+
+        IteratorBase() = default;
+        IteratorBase(SlotPtr cur, SlotPtr end) : cur_(cur), end_(end)
+        {
+            SkipEmpty();
+        }
+
+        // 允许从非const迭代器转换到const迭代器
+        template <bool OtherConst, std::enable_if_t<IsConst && !OtherConst, bool> = true>
+        IteratorBase(const IteratorBase<OtherConst> &other) : cur_(other.cur_), end_(other.end_) // NOLINT
+        {
+        }
+
+        reference operator*() const
+        {
+            return **cur_;
+        }
+
+        pointer operator->() const
+        {
+            return &**cur_;
+        }
+
+        IteratorBase &operator++()
+        {
+            ++cur_;
+            SkipEmpty();
+            return *this;
+        }
+
+        IteratorBase operator++(int)
+        {
+            auto tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        bool operator==(const IteratorBase &other) const
+        {
+            return cur_ == other.cur_;
+        }
+
+        bool operator!=(const IteratorBase &other) const
+        {
+            return cur_ != other.cur_;
+        }
+
+        friend class FlatHashMap;
+        friend class IteratorBase<!IsConst>;
+    };
+
+  public:
+    using iterator = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    FlatHashMap() = default;
+
+    explicit FlatHashMap(size_t expected_size)
+    {
+        reserve(expected_size);
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    iterator begin() noexcept
+    {
+        return {slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    iterator end() noexcept
+    {
+        return {slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+    }
+
+    const_iterator begin() const noexcept
+    {
+        return {slots_.data(), slots_.data() + slots_.size()};
+    }
+
+    const_iterator end() const noexcept
+    {
+        return {slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+    }
+
+    void clear() noexcept
+    {
+        for (auto &slot : slots_)
+            slot.reset();
+        size_ = 0;
+    }
+
+    void reserve(size_t expected_size)
+    {
+        size_t capacity = kMinCapacity;
+        while (capacity * kMaxLoadNum < expected_size * kMaxLoadDen)
+            capacity *= 2;
+
+        if (capacity > slots_.size())
+            Rehash(capacity);
+    }
+
+    iterator find(const TKey &key)
+    {
+        const size_t idx = FindIndex(key);
+        return idx == kNotFound ? end() : iterator(slots_.data() + idx, slots_.data() + slots_.size());
+    }
+
+    const_iterator find(const TKey &key) const
+    {
+        const size_t idx = FindIndex(key);
+        return idx == kNotFound ? end() : const_iterator(slots_.data() + idx, slots_.data() + slots_.size());
+    }
+
+    [[nodiscard]] size_t count(const TKey &key) const
+    {
+        return FindIndex(key) == kNotFound ? 0 : 1;
+    }
+
+    template <typename... Args> std::pair<iterator, bool> try_emplace(const TKey &key, Args &&...args)
+    {
+        if (const size_t idx = FindIndex(key); idx != kNotFound)
+            return {iterator(slots_.data() + idx, slots_.data() + slots_.size()), false};
+
+        if ((size_ + 1) * kMaxLoadDen > slots_.size() * kMaxLoadNum)
+            Rehash(slots_.empty() ? kMinCapacity : slots_.size() * 2);
+
+        size_t idx = BucketOf(key);
+        while (slots_[idx].has_value())
+            idx = (idx + 1) & (slots_.size() - 1);
+
+        slots_[idx].emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        ++size_;
+        return {iterator(slots_.data() + idx, slots_.data() + slots_.size()), true};
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value)
+    {
+        return try_emplace(value.first, value.second);
+    }
+
+    template <typename... Args> std::pair<iterator, bool> emplace(const TKey &key, Args &&...args)
+    {
+        return try_emplace(key, std::forward<Args>(args)...);
+    }
+
+    TValue &operator[](const TKey &key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    TValue &at(const TKey &key)
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("FlatHashMap::at(): key not found");
+        return it->second;
+    }
+
+    const TValue &at(const TKey &key) const
+    {
+        const auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("FlatHashMap::at(): key not found");
+        return it->second;
+    }
+
+    size_t erase(const TKey &key)
+    {
+        const size_t idx = FindIndex(key);
+        if (idx == kNotFound)
+            return 0;
+
+        EraseAt(idx);
+        return 1;
+    }
+
+    // 删除所有满足条件的元素，返回删除的数量。遍历中逐个删除可能因后移删除而重复访问元素，应使用此函数
+    template <typename Pred> size_t erase_if(Pred pred)
+    {
+        const size_t old_size = size_;
+        Vector<Slot> old_slots(slots_.size());
+        old_slots.swap(slots_);
+        size_ = 0;
+        for (auto &slot : old_slots)
+        {
+            if (!slot.has_value() || pred(std::as_const(*slot)))
+                continue;
+
+            size_t idx = BucketOf(slot->first);
+            while (slots_[idx].has_value())
+                idx = (idx + 1) & (slots_.size() - 1);
+            slots_[idx] = std::move(slot);
+            ++size_;
+        }
+        return old_size - size_;
+    }
+
+  private:
+    static constexpr size_t kMinCapacity = 16;
+    static constexpr size_t kMaxLoadNum = 3; // 最大负载因子 3/4
+    static constexpr size_t kMaxLoadDen = 4;
+    static constexpr size_t kNotFound = SIZE_MAX;
+
+    Vector<Slot> slots_;
+    size_t size_ = 0;
+
+    [[nodiscard]] size_t BucketOf(const TKey &key) const
+    {
+        // 部分标准库的std::hash对整数是恒等映射，乘以黄金分割常数打散低位
+        const auto h = static_cast<UInt64>(THash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h >> 32 ^ h) & (slots_.size() - 1);
+    }
+
+    [[nodiscard]] size_t FindIndex(const TKey &key) const
+    {
+        if (slots_.empty())
+            return kNotFound;
+
+        for (size_t idx = BucketOf(key);; idx = (idx + 1) & (slots_.size() - 1))
+        {
+            if (!slots_[idx].has_value())
+                return kNotFound;
+            if (TEqual{}(slots_[idx]->first, key))
+                return idx;
+        }
+    }
+
+    void EraseAt(size_t idx)
+    {
+        const size_t mask = slots_.size() - 1;
+        slots_[idx].reset();
+        --size_;
+
+        // 将后续探测链上的元素前移，填补空位
+        for (size_t next = (idx + 1) & mask; slots_[next].has_value(); next = (next + 1) & mask)
+        {
+            const size_t home = BucketOf(slots_[next]->first);
+            const bool in_range = idx <= next ? (home <= idx || home > next) : (home <= idx && home > next);
+            if (in_range)
+            {
+                slots_[idx] = std::move(slots_[next]);
+                slots_[next].reset();
+                idx = next;
+            }
+        }
+    }
+
+    void Rehash(size_t capacity)
+    {
+        Vector<Slot> old_slots(capacity);
+        old_slots.swap(slots_);
+        for (auto &slot : old_slots)
+        {
+            if (!slot.has_value())
+                continue;
+
+            size_t idx = BucketOf(slot->first);
+            while (slots_[idx].has_value())
+                idx = (idx + 1) & (capacity - 1);
+            slots_[idx] = std::move(slot);
+        }
+    }
+};
+} // namespace albc::util
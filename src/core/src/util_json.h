@@ -4,7 +4,10 @@
 #include "util_mem.h"
 #include "json/json.h"
 #include "external/byte_array_buffer.h"
+#include <algorithm>
 #include <fstream>
+#include <future>
+#include <thread>
 
 namespace albc::util
 {
@@ -96,6 +99,64 @@ static mem::PtrDictionary<std::string, TValue, TPtr> json_val_as_ptr_dictionary(
     return json_val_as_dictionary<TPtr<TValue>>(val, json_make_ptr<TPtr, TValue>, throw_on_error);
 }
 
+// 与json_val_as_ptr_dictionary结果相同，但将成员分块后在多个线程中构造。TValue的构造函数必须是线程安全的
+template <typename TValue, template <class...> typename TPtr = std::unique_ptr,
+        ALBC_REQUIRES(std::is_constructible_v<TValue, Json::Value>)>
+static mem::PtrDictionary<std::string, TValue, TPtr> json_val_as_ptr_dictionary_parallel(const Json::Value &val, bool throw_on_error = true)
+{
+#ifdef ALBC_HAVE_THREADS
+    constexpr auto kLaunchPolicy = std::launch::async;
+#else
+    constexpr auto kLaunchPolicy = std::launch::deferred;
+#endif
+    constexpr size_t kMinChunkSize = 64; // 成员较少时线程开销大于收益
+
+    using Member = std::pair<std::string, const Json::Value *>;
+    using Built = std::pair<std::string, TPtr<TValue>>;
+
+    Vector<Member> members;
+    members.reserve(val.size());
+    for (auto it = val.begin(); it != val.end(); ++it)
+        members.emplace_back(it.name(), &*it);
+
+    const size_t concurrency = std::max(1U, std::thread::hardware_concurrency());
+    const size_t chunk_size = std::max(kMinChunkSize, (members.size() + concurrency - 1) / concurrency);
+
+    // 每个线程构造到自己的缓冲区，互不共享
+    const auto build_chunk = [&members, throw_on_error](size_t begin, size_t end) {
+        Vector<Built> built;
+        built.reserve(end - begin);
+        for (size_t i = begin; i < end; ++i)
+        {
+            try
+            {
+                built.emplace_back(std::move(members[i].first), json_make_ptr<TPtr, TValue>(*members[i].second));
+            }
+            catch (const std::exception &e)
+            {
+                LOG_E(__PRETTY_FUNCTION__, ": Error appending item: ", e.what(), "\nRaw: ",
+                      members[i].second->toStyledString());
+                if (throw_on_error)
+                    throw;
+            }
+        }
+        return built;
+    };
+
+    Vector<std::future<Vector<Built>>> futures;
+    for (size_t begin = 0; begin < members.size(); begin += chunk_size)
+        futures.push_back(std::async(kLaunchPolicy, build_chunk, begin, std::min(begin + chunk_size, members.size())));
+
+    // 各块按成员顺序合并，Json对象成员本身有序，因此总是在末尾插入
+    mem::PtrDictionary<std::string, TValue, TPtr> dict;
+    for (auto &f : futures)
+    {
+        for (auto &[key, ptr] : f.get())
+            dict.emplace_hint(dict.end(), std::move(key), std::move(ptr));
+    }
+    return dict;
+}
+
 template <typename T>
 [[maybe_unused]] List<T> json_val_as_list(const Json::Value &val, T (*val_factory)(const Json::Value &json), bool throw_on_error = true)
 {
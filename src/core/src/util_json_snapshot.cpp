@@ -0,0 +1,277 @@
+#include "util_json_snapshot.h"
+#include "util_mmap.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace albc::util
+{
+namespace
+{
+class JsonSnapshotWriter
+{
+  public:
+    std::string Write(const Json::Value &root)
+    {
+        // 按层序遍历，保证同一容器的子节点在节点表中连续
+        Vector<const Json::Value *> queue{&root};
+        nodes_.emplace_back();
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            const auto &val = *queue[i];
+            nodes_[i].type = static_cast<UInt32>(val.type());
+            switch (val.type())
+            {
+            case Json::nullValue:
+                break;
+            case Json::intValue: {
+                const Int64 v = val.asInt64();
+                std::memcpy(&nodes_[i].payload, &v, sizeof v);
+                break;
+            }
+            case Json::uintValue:
+                nodes_[i].payload = val.asUInt64();
+                break;
+            case Json::realValue: {
+                const double v = val.asDouble();
+                std::memcpy(&nodes_[i].payload, &v, sizeof v);
+                break;
+            }
+            case Json::booleanValue:
+                nodes_[i].payload = val.asBool() ? 1 : 0;
+                break;
+            case Json::stringValue: {
+                const char *begin = nullptr;
+                const char *end = nullptr;
+                val.getString(&begin, &end);
+                const auto [offset, size] = Intern(std::string(begin, end));
+                nodes_[i].payload = offset;
+                nodes_[i].size = size;
+                break;
+            }
+            case Json::arrayValue:
+            case Json::objectValue: {
+                nodes_[i].payload = nodes_.size();
+                nodes_[i].size = static_cast<UInt32>(val.size());
+                for (auto it = val.begin(); it != val.end(); ++it)
+                {
+                    JsonSnapshotNode child{};
+                    if (val.isObject())
+                    {
+                        const auto [offset, size] = Intern(it.name());
+                        child.key_offset = offset;
+                        child.key_size = size;
+                    }
+                    nodes_.push_back(child);
+                    queue.push_back(&*it);
+                }
+                break;
+            }
+            }
+        }
+
+        JsonSnapshotHeader header{};
+        std::memcpy(header.magic, kJsonSnapshotMagic, sizeof header.magic);
+        header.format_version = kJsonSnapshotFormatVersion;
+        header.byte_order_mark = kJsonSnapshotByteOrderMark;
+        header.node_count = nodes_.size();
+        header.node_table_offset = sizeof(JsonSnapshotHeader);
+        header.string_pool_offset = header.node_table_offset + nodes_.size() * sizeof(JsonSnapshotNode);
+        header.string_pool_size = pool_.size();
+
+        std::string out;
+        out.reserve(header.string_pool_offset + pool_.size());
+        out.append(reinterpret_cast<const char *>(&header), sizeof header);
+        out.append(reinterpret_cast<const char *>(nodes_.data()), nodes_.size() * sizeof(JsonSnapshotNode));
+        out.append(pool_);
+        return out;
+    }
+
+  private:
+    Vector<JsonSnapshotNode> nodes_;
+    std::string pool_;
+    std::unordered_map<std::string, UInt32> pool_index_;
+
+    std::pair<UInt32, UInt32> Intern(const std::string &str)
+    {
+        if (str.size() > UINT32_MAX || pool_.size() > UINT32_MAX - str.size())
+            throw std::length_error("Json snapshot string pool overflow");
+
+        const auto [it, inserted] = pool_index_.try_emplace(str, static_cast<UInt32>(pool_.size()));
+        if (inserted)
+            pool_.append(str);
+        return {it->second, static_cast<UInt32>(str.size())};
+    }
+};
+
+class JsonSnapshotReader
+{
+  public:
+    JsonSnapshotReader(const char *data, size_t size)
+    {
+        if (!is_json_snapshot(data, size))
+            throw std::invalid_argument("Not a json snapshot");
+
+        JsonSnapshotHeader header;
+        std::memcpy(&header, data, sizeof header);
+        if (header.byte_order_mark != kJsonSnapshotByteOrderMark)
+            throw std::runtime_error("Json snapshot byte order mismatch");
+
+        if (header.format_version != kJsonSnapshotFormatVersion)
+            throw std::runtime_error("Unsupported json snapshot format version: " +
+                                     std::to_string(header.format_version));
+
+        if (header.node_count == 0 || header.node_table_offset > size ||
+            header.node_count > (size - header.node_table_offset) / sizeof(JsonSnapshotNode) ||
+            header.string_pool_offset > size || header.string_pool_size > size - header.string_pool_offset)
+            throw std::runtime_error("Corrupted json snapshot: invalid section bounds");
+
+        data_ = data;
+        header_ = header;
+    }
+
+    // 按层序逐个还原节点，不使用递归。每个容器的子节点必须恰好从层序游标处开始，
+    // 这样各容器的子节点区间互不重叠，每个节点只被还原一次，损坏的快照无法构造出指数级膨胀的文档或过深的调用栈
+    Json::Value Read() const
+    {
+        Json::Value root;
+        Vector<Json::Value *> targets(header_.node_count, nullptr); // 各节点在还原后的文档中的位置
+        targets[0] = &root;
+        UInt64 next_child = 1;
+
+        for (UInt64 index = 0; index < header_.node_count; ++index)
+        {
+            if (!targets[index])
+                throw std::runtime_error("Corrupted json snapshot: unreachable node");
+
+            const auto node = GetNode(index);
+            if (node.type == Json::arrayValue || node.type == Json::objectValue)
+            {
+                if (node.payload != next_child || node.size > header_.node_count - next_child)
+                    throw std::runtime_error("Corrupted json snapshot: child range out of order");
+                next_child += node.size;
+            }
+            ReadNode(node, *targets[index], targets);
+        }
+
+        if (next_child != header_.node_count)
+            throw std::runtime_error("Corrupted json snapshot: unreachable node");
+        return root;
+    }
+
+  private:
+    const char *data_ = nullptr;
+    JsonSnapshotHeader header_{};
+
+    [[nodiscard]] JsonSnapshotNode GetNode(UInt64 index) const
+    {
+        JsonSnapshotNode node;
+        std::memcpy(&node, data_ + header_.node_table_offset + index * sizeof(JsonSnapshotNode), sizeof node);
+        return node;
+    }
+
+    [[nodiscard]] const char *GetString(UInt64 offset, UInt64 size) const
+    {
+        if (offset > header_.string_pool_size || size > header_.string_pool_size - offset)
+            throw std::runtime_error("Corrupted json snapshot: string out of bounds");
+        return data_ + header_.string_pool_offset + offset;
+    }
+
+    // 还原单个节点。容器只创建其子节点的位置并记录到targets中，子节点的值在之后按层序还原
+    void ReadNode(const JsonSnapshotNode &node, Json::Value &out, Vector<Json::Value *> &targets) const
+    {
+        switch (node.type)
+        {
+        case Json::nullValue:
+            out = Json::Value();
+            break;
+        case Json::intValue: {
+            Int64 v;
+            std::memcpy(&v, &node.payload, sizeof v);
+            out = Json::Value(static_cast<Json::Int64>(v));
+            break;
+        }
+        case Json::uintValue:
+            out = Json::Value(static_cast<Json::UInt64>(node.payload));
+            break;
+        case Json::realValue: {
+            double v;
+            std::memcpy(&v, &node.payload, sizeof v);
+            out = Json::Value(v);
+            break;
+        }
+        case Json::booleanValue:
+            out = Json::Value(node.payload != 0);
+            break;
+        case Json::stringValue: {
+            const char *str = GetString(node.payload, node.size);
+            out = Json::Value(str, str + node.size);
+            break;
+        }
+        case Json::arrayValue:
+        case Json::objectValue: {
+            // jsoncpp的容器以std::map存放子节点，插入后已有子节点的地址不变
+            const bool is_object = node.type == Json::objectValue;
+            out = Json::Value(is_object ? Json::objectValue : Json::arrayValue);
+            if (!is_object)
+                out.resize(node.size);
+
+            for (UInt32 i = 0; i < node.size; ++i)
+            {
+                const UInt64 child_index = node.payload + i;
+                if (is_object)
+                {
+                    const auto child = GetNode(child_index);
+                    const char *key = GetString(child.key_offset, child.key_size);
+                    targets[child_index] = out.demand(key, key + child.key_size);
+                    // 重复的键会让两个节点指向同一位置，后者覆盖时前者记录的子节点位置将失效
+                    if (out.size() != i + 1)
+                        throw std::runtime_error("Corrupted json snapshot: duplicate object key");
+                }
+                else
+                {
+                    targets[child_index] = &out[i];
+                }
+            }
+            break;
+        }
+        default:
+            throw std::runtime_error("Corrupted json snapshot: unknown node type: " + std::to_string(node.type));
+        }
+    }
+};
+} // namespace
+
+bool is_json_snapshot(const char *data, size_t size) noexcept
+{
+    return data && size >= sizeof(JsonSnapshotHeader) &&
+           std::memcmp(data, kJsonSnapshotMagic, sizeof kJsonSnapshotMagic) == 0;
+}
+
+std::string compile_json_snapshot(const Json::Value &root)
+{
+    return JsonSnapshotWriter().Write(root);
+}
+
+Json::Value read_json_snapshot(const char *data, size_t size)
+{
+    return JsonSnapshotReader(data, size).Read();
+}
+
+Json::Value read_json_or_snapshot_from_file(const std::string &path)
+{
+    const MappedFile file(path);
+    if (is_json_snapshot(file.data(), file.size()))
+        return read_json_snapshot(file.data(), file.size());
+
+    Json::Value result;
+    Json::CharReaderBuilder builder;
+    const std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+    std::string errs;
+    if (!reader->parse(file.data(), file.data() + file.size(), &result, &errs))
+        throw std::runtime_error("Failed to parse json: " + path + ": " + errs);
+
+    return result;
+}
+} // namespace albc::util
@@ -0,0 +1,54 @@
+#pragma once
+#include "albc_types.h"
+#include "json/json.h"
+
+#include <string>
+
+namespace albc::util
+{
+/*
+ * Json快照：将Json文档预编译为与位置无关的二进制格式，加载时无需词法/语法分析。
+ *
+ * 布局（小端序，所有偏移均相对于文件起始位置）：
+ *   JsonSnapshotHeader
+ *   JsonSnapshotNode[node_count]    定长节点表，按层序排列，同一容器的子节点连续存放，根节点下标为0
+ *   char[string_pool_size]          字符串池，相同的字符串（包括键名）只存放一次
+ */
+constexpr char kJsonSnapshotMagic[8] = {'A', 'L', 'B', 'C', 'S', 'N', 'A', 'P'};
+constexpr UInt32 kJsonSnapshotFormatVersion = 1;
+constexpr UInt32 kJsonSnapshotByteOrderMark = 0x01020304;
+
+struct JsonSnapshotHeader
+{
+    char magic[8];
+    UInt32 format_version;
+    UInt32 byte_order_mark;
+    UInt64 node_count;
+    UInt64 node_table_offset;
+    UInt64 string_pool_offset;
+    UInt64 string_pool_size;
+};
+
+struct JsonSnapshotNode
+{
+    UInt32 type;        // Json::ValueType
+    UInt32 key_offset;  // 作为对象成员时，键名在字符串池中的偏移
+    UInt32 key_size;
+    UInt32 size;        // 字符串长度或容器的子节点数量
+    UInt64 payload;     // 数值的二进制表示、字符串在字符串池中的偏移或容器首个子节点的下标
+};
+
+static_assert(sizeof(JsonSnapshotHeader) == 48);
+static_assert(sizeof(JsonSnapshotNode) == 24);
+
+[[nodiscard]] bool is_json_snapshot(const char *data, size_t size) noexcept;
+
+// 将Json文档编译为快照
+[[nodiscard]] std::string compile_json_snapshot(const Json::Value &root);
+
+// 从快照还原Json文档，快照格式不正确时抛出异常
+[[nodiscard]] Json::Value read_json_snapshot(const char *data, size_t size);
+
+// 以内存映射方式读取文件，自动识别快照格式与Json文本格式
+[[nodiscard]] Json::Value read_json_or_snapshot_from_file(const std::string &path);
+} // namespace albc::util
@@ -0,0 +1,330 @@
+#include "util_json_stream.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace albc::util
+{
+JsonStreamReader::JsonStreamReader(const char *begin, const char *end) : begin_(begin), cur_(begin), end_(end)
+{
+    // 跳过UTF-8 BOM
+    if (end_ - cur_ >= 3 && static_cast<unsigned char>(cur_[0]) == 0xEF &&
+        static_cast<unsigned char>(cur_[1]) == 0xBB && static_cast<unsigned char>(cur_[2]) == 0xBF)
+        cur_ += 3;
+}
+
+void JsonStreamReader::Fail(const char *what) const
+{
+    throw std::runtime_error(std::string("Failed to parse json: ")
+                                 .append(what)
+                                 .append(" at offset ")
+                                 .append(std::to_string(cur_ - begin_)));
+}
+
+void JsonStreamReader::SkipWhitespace()
+{
+    while (cur_ < end_ && (*cur_ == ' ' || *cur_ == '\t' || *cur_ == '\n' || *cur_ == '\r'))
+        ++cur_;
+}
+
+char JsonStreamReader::Peek()
+{
+    SkipWhitespace();
+    if (cur_ >= end_)
+        Fail("unexpected end of input");
+    return *cur_;
+}
+
+void JsonStreamReader::Expect(char c)
+{
+    if (Peek() != c)
+        Fail((std::string("expected '") + c + "'").c_str());
+    ++cur_;
+}
+
+bool JsonStreamReader::TryConsume(char c)
+{
+    if (Peek() != c)
+        return false;
+    ++cur_;
+    return true;
+}
+
+void JsonStreamReader::ExpectLiteral(std::string_view literal)
+{
+    if (static_cast<size_t>(end_ - cur_) < literal.size() || std::string_view(cur_, literal.size()) != literal)
+        Fail("invalid literal");
+    cur_ += literal.size();
+}
+
+UInt32 JsonStreamReader::ReadHex4()
+{
+    if (end_ - cur_ < 4)
+        Fail("unexpected end of input in unicode escape");
+
+    UInt32 value = 0;
+    for (int i = 0; i < 4; ++i, ++cur_)
+    {
+        const char c = *cur_;
+        value <<= 4;
+        if (c >= '0' && c <= '9')
+            value |= c - '0';
+        else if (c >= 'a' && c <= 'f')
+            value |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F')
+            value |= c - 'A' + 10;
+        else
+            Fail("invalid unicode escape");
+    }
+    return value;
+}
+
+void JsonStreamReader::AppendUtf8(std::string &out, UInt32 code_point)
+{
+    if (code_point < 0x80)
+    {
+        out.push_back(static_cast<char>(code_point));
+    }
+    else if (code_point < 0x800)
+    {
+        out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else if (code_point < 0x10000)
+    {
+        out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+    else
+    {
+        out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+    }
+}
+
+void JsonStreamReader::ReadString(std::string &out)
+{
+    Expect('"');
+    out.clear();
+    while (true)
+    {
+        // 成段拷贝不含转义的部分
+        const char *run_end = std::find_if(cur_, end_, [](char c) { return c == '"' || c == '\\'; });
+        out.append(cur_, run_end);
+        cur_ = run_end;
+        if (cur_ >= end_)
+            Fail("unterminated string");
+
+        if (*cur_ == '"')
+        {
+            ++cur_;
+            return;
+        }
+
+        ++cur_; // '\\'
+        if (cur_ >= end_)
+            Fail("unterminated string");
+
+        switch (*cur_++)
+        {
+        case '"': out.push_back('"'); break;
+        case '\\': out.push_back('\\'); break;
+        case '/': out.push_back('/'); break;
+        case 'b': out.push_back('\b'); break;
+        case 'f': out.push_back('\f'); break;
+        case 'n': out.push_back('\n'); break;
+        case 'r': out.push_back('\r'); break;
+        case 't': out.push_back('\t'); break;
+        case 'u': {
+            UInt32 code_point = ReadHex4();
+            if (code_point >= 0xD800 && code_point < 0xDC00)
+            {
+                if (end_ - cur_ < 2 || cur_[0] != '\\' || cur_[1] != 'u')
+                    Fail("unpaired surrogate in unicode escape");
+                cur_ += 2;
+                const UInt32 low = ReadHex4();
+                if (low < 0xDC00 || low >= 0xE000)
+                    Fail("invalid surrogate pair in unicode escape");
+                code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            }
+            AppendUtf8(out, code_point);
+            break;
+        }
+        default:
+            Fail("invalid escape sequence");
+        }
+    }
+}
+
+void JsonStreamReader::SkipString()
+{
+    Expect('"');
+    while (cur_ < end_)
+    {
+        const char c = *cur_++;
+        if (c == '"')
+            return;
+        if (c == '\\')
+            ++cur_;
+    }
+    Fail("unterminated string");
+}
+
+void JsonStreamReader::SkipNumber()
+{
+    while (cur_ < end_ && (std::isdigit(static_cast<unsigned char>(*cur_)) || *cur_ == '-' || *cur_ == '+' ||
+                           *cur_ == '.' || *cur_ == 'e' || *cur_ == 'E'))
+        ++cur_;
+}
+
+Json::Value JsonStreamReader::ReadNumber()
+{
+    const char *start = cur_;
+    SkipNumber();
+    if (start == cur_)
+        Fail("invalid value");
+
+    const std::string text(start, cur_);
+    const bool is_integer = text.find_first_of(".eE") == std::string::npos;
+    char *parse_end = nullptr;
+    errno = 0;
+    if (is_integer && text[0] == '-')
+    {
+        const long long v = std::strtoll(text.c_str(), &parse_end, 10);
+        if (errno == 0 && *parse_end == '\0')
+            return Json::Value(static_cast<Json::Int64>(v));
+    }
+    else if (is_integer)
+    {
+        const unsigned long long v = std::strtoull(text.c_str(), &parse_end, 10);
+        if (errno == 0 && *parse_end == '\0')
+        {
+            // 与jsoncpp一致：能以有符号整数表示的值保存为intValue
+            if (v <= static_cast<unsigned long long>(Json::Value::maxInt64))
+                return Json::Value(static_cast<Json::Int64>(v));
+            return Json::Value(static_cast<Json::UInt64>(v));
+        }
+    }
+
+    errno = 0;
+    const double v = std::strtod(text.c_str(), &parse_end);
+    if (*parse_end != '\0')
+        Fail("invalid number");
+    return Json::Value(v);
+}
+
+void JsonStreamReader::SkipValue()
+{
+    // 以深度计数代替递归，任意深度的子树都不会耗尽栈空间
+    size_t depth = 0;
+    do
+    {
+        switch (Peek())
+        {
+        case '{':
+        case '[':
+            ++cur_;
+            ++depth;
+            continue;
+        case '}':
+        case ']':
+            if (depth == 0)
+                Fail("unexpected closing bracket");
+            ++cur_;
+            --depth;
+            break;
+        case ',':
+        case ':':
+            if (depth == 0)
+                Fail("unexpected separator");
+            ++cur_;
+            continue;
+        case '"':
+            SkipString();
+            break;
+        case 't':
+            ExpectLiteral("true");
+            break;
+        case 'f':
+            ExpectLiteral("false");
+            break;
+        case 'n':
+            ExpectLiteral("null");
+            break;
+        default: {
+            const char *start = cur_;
+            SkipNumber();
+            if (start == cur_)
+                Fail("invalid value");
+            break;
+        }
+        }
+    } while (depth > 0);
+}
+
+Json::Value JsonStreamReader::ReadValue()
+{
+    switch (Peek())
+    {
+    case '{': {
+        Json::Value val(Json::objectValue);
+        ReadObject([&](const std::string &key) { val[key] = ReadValue(); });
+        return val;
+    }
+    case '[': {
+        Json::Value val(Json::arrayValue);
+        ++cur_;
+        if (TryConsume(']'))
+            return val;
+
+        do
+        {
+            val.append(ReadValue());
+        } while (TryConsume(','));
+        Expect(']');
+        return val;
+    }
+    case '"': {
+        std::string str;
+        ReadString(str);
+        return Json::Value(str);
+    }
+    case 't':
+        ExpectLiteral("true");
+        return Json::Value(true);
+    case 'f':
+        ExpectLiteral("false");
+        return Json::Value(false);
+    case 'n':
+        ExpectLiteral("null");
+        return {};
+    default:
+        return ReadNumber();
+    }
+}
+
+Json::Value JsonStreamReader::ReadObjectFields(std::initializer_list<std::string_view> keys)
+{
+    Json::Value val(Json::objectValue);
+    ReadObject([&](const std::string &key) {
+        if (std::find(keys.begin(), keys.end(), key) != keys.end())
+            val[key] = ReadValue();
+        else
+            SkipValue();
+    });
+    return val;
+}
+
+void JsonStreamReader::ExpectEnd()
+{
+    SkipWhitespace();
+    if (cur_ != end_)
+        Fail("unexpected trailing characters");
+}
+} // namespace albc::util
@@ -0,0 +1,69 @@
+#pragma once
+#include "albc_types.h"
+#include "json/json.h"
+
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace albc::util
+{
+/**
+ * @brief 单遍扫描的流式Json读取器
+ *
+ * 调用者按文档结构逐层遍历，只把需要的子树构造为Json::Value，其余子树直接跳过，不分配任何节点。
+ * 格式错误时抛出std::runtime_error，信息中包含出错位置的字节偏移。
+ */
+class JsonStreamReader
+{
+  public:
+    JsonStreamReader(const char *begin, const char *end);
+
+    // 遍历对象的成员，handler(const std::string& key)必须读取或跳过对应的值
+    template <typename Handler> void ReadObject(Handler &&handler)
+    {
+        std::string key;
+        Expect('{');
+        if (TryConsume('}'))
+            return;
+
+        do
+        {
+            ReadString(key);
+            Expect(':');
+            handler(key);
+        } while (TryConsume(','));
+        Expect('}');
+    }
+
+    // 跳过当前值（包括整个子树）
+    void SkipValue();
+
+    // 将当前值完整地构造为Json::Value
+    [[nodiscard]] Json::Value ReadValue();
+
+    // 读取一个对象，只构造keys中列出的成员，其余成员被跳过
+    [[nodiscard]] Json::Value ReadObjectFields(std::initializer_list<std::string_view> keys);
+
+    // 确认文档已经结束（其后只有空白）
+    void ExpectEnd();
+
+  private:
+    const char *begin_;
+    const char *cur_;
+    const char *end_;
+
+    [[noreturn]] void Fail(const char *what) const;
+    void SkipWhitespace();
+    [[nodiscard]] char Peek();
+    void Expect(char c);
+    bool TryConsume(char c);
+    void ExpectLiteral(std::string_view literal);
+    void ReadString(std::string &out);
+    void SkipString();
+    [[nodiscard]] Json::Value ReadNumber();
+    void SkipNumber();
+    void AppendUtf8(std::string &out, UInt32 code_point);
+    [[nodiscard]] UInt32 ReadHex4();
+};
+} // namespace albc::util
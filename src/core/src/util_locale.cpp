@@ -1,6 +1,10 @@
 #include "util_locale.h"
 #include "util_log.h"
 
+#include <array>
+#include <cctype>
+#include <optional>
+
 #ifdef ALBC_HAVE_ICU
 #if __has_include(<icu.h>)
 #   include <icu.h>
@@ -11,40 +15,148 @@
 
 namespace albc::util
 {
+#ifdef ALBC_HAVE_ICU
+namespace
+{
+struct ConverterCloser
+{
+    void operator()(UConverter *cnv) const noexcept
+    {
+        ucnv_close(cnv);
+    }
+};
+using ConverterPtr = std::unique_ptr<UConverter, ConverterCloser>;
+
+// UConverter不能跨线程共享，每个线程按编码名缓存自己打开的转换器
+UConverter *GetThreadConverter(const char *code)
+{
+    thread_local Vector<std::pair<std::string, ConverterPtr>> converters;
+    for (const auto &[name, cnv] : converters)
+    {
+        if (name == code)
+            return cnv.get();
+    }
+
+    UErrorCode err = U_ZERO_ERROR;
+    ConverterPtr cnv(ucnv_open(code, &err));
+    if (U_FAILURE(err))
+        throw std::runtime_error(std::string("Failed to open converter: ") + code);
+
+    return converters.emplace_back(code, std::move(cnv)).second.get();
+}
+
+std::string Convert(const std::string_view &src, const char *from_code, const char *to_code)
+{
+    UConverter *from_cnv = GetThreadConverter(from_code);
+    UConverter *to_cnv = GetThreadConverter(to_code);
+
+    // 源编码中每个字符至少占一个字节，转换为UTF-16后码元数一般不超过字节数；不足时按返回的长度重试
+    thread_local Vector<UChar> pivot;
+    const auto src_len = static_cast<int32_t>(src.size());
+    pivot.resize(src.size() + 1);
+    UErrorCode err = U_ZERO_ERROR;
+    int32_t pivot_len =
+        ucnv_toUChars(from_cnv, pivot.data(), static_cast<int32_t>(pivot.size()), src.data(), src_len, &err);
+    if (err == U_BUFFER_OVERFLOW_ERROR)
+    {
+        err = U_ZERO_ERROR;
+        pivot.resize(static_cast<size_t>(pivot_len) + 1);
+        pivot_len =
+            ucnv_toUChars(from_cnv, pivot.data(), static_cast<int32_t>(pivot.size()), src.data(), src_len, &err);
+    }
+    if (U_FAILURE(err))
+        throw std::runtime_error("Failed to convert string to target locale");
+
+    std::string out(UCNV_GET_MAX_BYTES_FOR_STRING(pivot_len, ucnv_getMaxCharSize(to_cnv)), '\0');
+    int32_t out_len =
+        ucnv_fromUChars(to_cnv, out.data(), static_cast<int32_t>(out.size()), pivot.data(), pivot_len, &err);
+    if (err == U_BUFFER_OVERFLOW_ERROR)
+    {
+        err = U_ZERO_ERROR;
+        out.resize(static_cast<size_t>(out_len));
+        out_len = ucnv_fromUChars(to_cnv, out.data(), static_cast<int32_t>(out.size()), pivot.data(), pivot_len, &err);
+    }
+    if (U_FAILURE(err))
+        throw std::runtime_error("Failed to convert string to target locale");
+
+    out.resize(static_cast<size_t>(out_len));
+    return out;
+}
+
+// 最近转换过的短字符串（干员标识符、名称等会被反复转换），按哈希直接映射，每个线程独立
+struct CachedConversion
+{
+    std::string from_code;
+    std::string to_code;
+    std::string src;
+    std::string dst;
+};
+constexpr size_t kConversionCacheSize = 64;
+constexpr size_t kMaxCachedStringLength = 256;
+
+std::string ConvertCached(const std::string_view &src, const char *from_code, const char *to_code)
+{
+    if (src.size() > kMaxCachedStringLength)
+        return Convert(src, from_code, to_code);
+
+    thread_local std::array<std::optional<CachedConversion>, kConversionCacheSize> cache;
+    auto &entry = cache[std::hash<std::string_view>{}(src) & (kConversionCacheSize - 1)];
+    if (entry && entry->src == src && entry->to_code == to_code && entry->from_code == from_code)
+        return entry->dst;
+
+    auto dst = Convert(src, from_code, to_code);
+    entry = CachedConversion{from_code, to_code, std::string(src), dst};
+    return dst;
+}
+} // namespace
+#endif
+
+bool IsSameEncoding(std::string_view lhs, std::string_view rhs) noexcept
+{
+    const auto next = [](std::string_view &s) -> int {
+        while (!s.empty() && (s.front() == '-' || s.front() == '_'))
+            s.remove_prefix(1);
+        if (s.empty())
+            return -1;
+        const int c = std::tolower(static_cast<unsigned char>(s.front()));
+        s.remove_prefix(1);
+        return c;
+    };
+
+    while (true)
+    {
+        const int a = next(lhs);
+        const int b = next(rhs);
+        if (a != b)
+            return false;
+        if (a < 0)
+            return true;
+    }
+}
 
 std:: string ToTargetLocale(const std::string_view &src, const char *from_code, const char *to_code)
 {
     if (!from_code || !to_code)
         return {};
 
-    if (strcmp(from_code, to_code) == 0)
-        return src.data();
+    if (IsSameEncoding(from_code, to_code))
+        return std::string(src);
 
     try
     {
 #ifdef ALBC_HAVE_ICU
-        UErrorCode err = U_ZERO_ERROR;
-        auto in_len = static_cast<int32_t>(src.size() + 1);
-        auto out_buf_size = static_cast<int32_t>(in_len * 4 + 1);
-        auto out_buf = std::make_unique<char[]>( out_buf_size );
-
-        ucnv_convert(to_code, from_code, out_buf.get(), out_buf_size, src.data(), in_len, &err);
-        if (U_FAILURE(err))
-        {
-            throw std::runtime_error("Failed to convert string to target locale");
-        }
-        return { out_buf.get() };
+        return ConvertCached(src, from_code, to_code);
 #else
         (void)src; (void)from_code; (void)to_code;
         static std::once_flag once;
         std::call_once(once, []() { std::cout << "ALBC|ICU is not available" << std::endl; });
-        return src.data();
+        return std::string(src);
 #endif
     }
     catch (std::exception &e)
     {
         LOG_E("Failed to convert string: ", e.what(), " from_code: ", from_code, " to_code: ", to_code);
-        return src.data();
+        return std::string(src);
     }
 }
 
@@ -28,6 +28,10 @@ class GlobalLocale
     }
 };
 
+// 判断两个编码名是否指同一编码，忽略大小写以及'-'、'_'（如"UTF-8"与"utf8"）
+bool IsSameEncoding(std::string_view lhs, std::string_view rhs) noexcept;
+
+// 编码相同时直接复制；否则使用当前线程缓存的转换器转换，较短的字符串的转换结果也按线程缓存
 std::string ToTargetLocale(const std::string_view &src, const char* from_code = kDefaultLocale, const char* to_code = kDefaultLocale);
 
 bool CheckTargetLocale(const char* locale);
@@ -0,0 +1,100 @@
+#include "util_mmap.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace albc::util
+{
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &path)
+{
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Unable to open file: " + path);
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to get size of file: " + path);
+    }
+
+    file_handle_ = file;
+    size_ = static_cast<size_t>(file_size.QuadPart);
+    if (size_ == 0)
+        return;
+
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+
+    mapping_handle_ = mapping;
+    data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data_)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Unable to map file: " + path);
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        UnmapViewOfFile(data_);
+    if (mapping_handle_)
+        CloseHandle(mapping_handle_);
+    if (file_handle_)
+        CloseHandle(file_handle_);
+}
+#else
+MappedFile::MappedFile(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("Unable to open file: " + path);
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        throw std::runtime_error("Unable to get size of file: " + path);
+    }
+
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    void *addr = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // 映射建立后即可关闭文件描述符
+    if (addr == MAP_FAILED)
+        throw std::runtime_error("Unable to map file: " + path);
+
+    data_ = addr;
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+        munmap(const_cast<void *>(data_), size_);
+}
+#endif
+} // namespace albc::util
@@ -0,0 +1,36 @@
+#pragma once
+#include "albc_types.h"
+
+#include <string>
+
+namespace albc::util
+{
+// 只读内存映射文件，映射在对象析构时解除
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] const char *data() const noexcept
+    {
+        return static_cast<const char *>(data_);
+    }
+
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return size_;
+    }
+
+  private:
+    const void *data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void *file_handle_ = nullptr;
+    void *mapping_handle_ = nullptr;
+#endif
+};
+} // namespace albc::util
@@ -0,0 +1,62 @@
+#include "util_string_interner.h"
+
+#include <mutex>
+#include <stdexcept>
+
+namespace albc::util
+{
+StringInterner::StringInterner()
+{
+    strings_.emplace_back();
+    index_.emplace(strings_.back(), kEmptyStringId);
+}
+
+StringId StringInterner::Intern(std::string_view str)
+{
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        if (const auto it = index_.find(str); it != index_.end())
+            return it->second;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (const auto it = index_.find(str); it != index_.end())
+        return it->second;
+
+    if (strings_.size() > UINT32_MAX)
+        throw std::length_error("StringInterner::Intern(): too many strings");
+
+    const auto id = static_cast<StringId>(strings_.size());
+    strings_.emplace_back(str);
+    index_.emplace(strings_.back(), id);
+    return id;
+}
+
+std::optional<StringId> StringInterner::Find(std::string_view str) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (const auto it = index_.find(str); it != index_.end())
+        return it->second;
+    return std::nullopt;
+}
+
+const std::string &StringInterner::GetString(StringId id) const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (id >= strings_.size())
+        throw std::out_of_range("StringInterner::GetString(): invalid string id: " + std::to_string(id));
+    return strings_[id];
+}
+
+size_t StringInterner::Size() const
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return strings_.size();
+}
+
+StringInterner &GetGlobalStringInterner()
+{
+    static StringInterner interner;
+    return interner;
+}
+} // namespace albc::util
@@ -0,0 +1,63 @@
+#pragma once
+#include "albc_types.h"
+
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace albc::util
+{
+// 驻留字符串的紧凑整数Id，只在进程内有效，不应被持久化
+using StringId = UInt32;
+
+// 空字符串的Id固定为0
+inline constexpr StringId kEmptyStringId = 0;
+
+/**
+ * @brief 线程安全的字符串驻留表，将字符串映射为从0开始连续分配的Id
+ *
+ * 同一字符串总是得到同一个Id，比较和哈希Id代替比较和哈希字符串。已驻留的字符串在表的生命周期内地址不变。
+ * 表只增不减，因此只驻留来自游戏数据的字符串；来自请求的字符串使用Find查找，不会使表增长。
+ */
+class StringInterner
+{
+  public:
+    StringInterner();
+
+    StringInterner(const StringInterner &) = delete;
+    StringInterner &operator=(const StringInterner &) = delete;
+
+    // 返回字符串的Id，未驻留时分配新Id
+    [[nodiscard]] StringId Intern(std::string_view str);
+
+    // 返回已驻留字符串的Id，未驻留时返回std::nullopt，不分配新Id
+    [[nodiscard]] std::optional<StringId> Find(std::string_view str) const;
+
+    // 返回Id对应的字符串，Id无效时抛出std::out_of_range
+    [[nodiscard]] const std::string &GetString(StringId id) const;
+
+    [[nodiscard]] size_t Size() const;
+
+  private:
+    mutable std::shared_mutex mutex_;
+    std::deque<std::string> strings_; // deque在尾部插入时不移动已有元素，索引中的string_view保持有效
+    std::unordered_map<std::string_view, StringId> index_;
+};
+
+[[nodiscard]] StringInterner &GetGlobalStringInterner();
+
+// 在全局驻留表中驻留字符串，只用于来自游戏数据的字符串
+[[nodiscard]] inline StringId intern_string(std::string_view str)
+{
+    return str.empty() ? kEmptyStringId : GetGlobalStringInterner().Intern(str);
+}
+
+// 在全局驻留表中查找字符串，未驻留时返回kEmptyStringId。用于来自请求的字符串
+[[nodiscard]] inline StringId find_interned_string(std::string_view str)
+{
+    return str.empty() ? kEmptyStringId : GetGlobalStringInterner().Find(str).value_or(kEmptyStringId);
+}
+} // namespace albc::util
@@ -0,0 +1,91 @@
+#include "util_thread_pool.h"
+
+#include <algorithm>
+
+namespace albc::util
+{
+#ifdef ALBC_HAVE_THREADS
+ThreadPool::ThreadPool(size_t thread_count) : thread_count_(std::max<size_t>(1, thread_count))
+{
+    threads_.reserve(thread_count_);
+    try
+    {
+        for (size_t i = 0; i < thread_count_; ++i)
+            threads_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+    catch (...)
+    {
+        // 部分线程已启动，先让它们退出再转发异常
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto &thread : threads_)
+            thread.join();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    auto future = packaged.get_future();
+    {
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(packaged));
+    }
+    cv_.notify_one();
+    return future;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty())
+                return; // stopping_且队列已清空
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task(); // 异常保存在future中
+    }
+}
+#else
+ThreadPool::ThreadPool(size_t thread_count) : thread_count_(std::max<size_t>(1, thread_count))
+{
+}
+
+ThreadPool::~ThreadPool() = default;
+
+std::future<void> ThreadPool::Submit(std::function<void()> task)
+{
+    std::packaged_task<void()> packaged(std::move(task));
+    auto future = packaged.get_future();
+    packaged();
+    return future;
+}
+#endif
+
+ThreadPool &GetSharedThreadPool()
+{
+    // 有意不析构：进程退出或动态库卸载时工作线程可能已被系统终止，在静态析构中join会卡住
+    static auto *const pool = new ThreadPool(std::thread::hardware_concurrency());
+    return *pool;
+}
+} // namespace albc::util
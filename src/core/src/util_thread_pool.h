@@ -0,0 +1,46 @@
+#pragma once
+#include "albc_types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace albc::util
+{
+// 常驻的工作线程池，任务按提交顺序执行。没有线程支持时任务在Submit中同步执行
+class ThreadPool
+{
+  public:
+    explicit ThreadPool(size_t thread_count);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // 提交任务，返回的future在任务完成时就绪，任务抛出的异常由future转发
+    std::future<void> Submit(std::function<void()> task);
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return thread_count_;
+    }
+
+  private:
+    size_t thread_count_;
+#ifdef ALBC_HAVE_THREADS
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::packaged_task<void()>> tasks_;
+    Vector<std::thread> threads_;
+    bool stopping_ = false;
+
+    void WorkerLoop();
+#endif
+};
+
+// 进程内共享的线程池，线程数为硬件线程数，首次调用时创建
+ThreadPool &GetSharedThreadPool();
+} // namespace albc::util
@@ -7,19 +7,23 @@ namespace albc::xml
     [[maybe_unused]]
     static std::string strip_xml_tags(const std::string &str)
     {
-        std::string result = str;
-        size_t start_pos = 0;
-        while ((start_pos = result.find('<', start_pos)) != std::string::npos)
+        // 单遍扫描拷贝标签之外的部分，避免反复erase
+        std::string result;
+        result.reserve(str.size());
+        size_t pos = 0;
+        while (pos < str.size())
         {
-            size_t end_pos = result.find('>', start_pos);
-            if (end_pos != std::string::npos)
+            const size_t start_pos = str.find('<', pos);
+            if (start_pos == std::string::npos)
             {
-                result.erase(start_pos, end_pos - start_pos + 1);
-            }
-            else
-            {
-                result.erase(start_pos, 1);
+                result.append(str, pos, std::string::npos);
+                break;
             }
+
+            result.append(str, pos, start_pos - pos);
+            const size_t end_pos = str.find('>', start_pos);
+            // 没有闭合的'<'只删除其本身
+            pos = end_pos != std::string::npos ? end_pos + 1 : start_pos + 1;
         }
         return result;
     }